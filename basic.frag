@@ -1,9 +1,12 @@
 #version 450
 
 layout (location = 0) in vec3 f_color;
+layout (location = 1) in vec2 f_uv;
 layout (location = 0) out vec4 frag_color;
 
+layout (binding = 0) uniform sampler2D albedo;
+
 void main()
 {
-    frag_color = vec4(f_color, 1);
+    frag_color = vec4(f_color * texture(albedo, f_uv).rgb, 1);
 }
\ No newline at end of file
@@ -1,20 +1,19 @@
 #version 450
 
-layout (location = 0) out vec3 v_color;
+layout (location = 0) in vec4 position; // quantized relative to the mesh's bounds, see mesh_format.hpp
+layout (location = 1) in vec4 color;
+layout (location = 2) in vec2 uv;
 
-vec2 positions[3] = vec2[](
-    vec2(0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
+layout (push_constant) uniform MeshBounds {
+    vec4 center;
+    vec4 half_extent;
+} bounds;
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
+layout (location = 0) out vec3 v_color;
+layout (location = 1) out vec2 v_uv;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    v_color = colors[gl_VertexIndex];
+    gl_Position = vec4(bounds.center.xyz + position.xyz * bounds.half_extent.xyz, 1.0);
+    v_color = color.rgb;
+    v_uv = uv;
 }
\ No newline at end of file
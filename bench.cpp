@@ -0,0 +1,890 @@
+#include <mimalloc-new-delete.h>  // the same allocator as mini-vk, so that the numbers are representative
+
+#include "vulkan_common.hpp"
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE  // has to be defined exactly
+                                                    // once when using
+                                                    // VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+
+// Headless benchmarks of mini-vk's hot paths, driving the same scene code (scene.hpp). Every scene runs a fixed number of
+// iterations against an offscreen render target, so any Vulkan implementation works, including software ones like
+// lavapipe. The results are written as JSON and, when a baseline recorded on the same device is given, compared against
+// it; CTest runs it that way (see CMakeLists.txt).
+// Usage: mini-vk-bench <results.json> [<baseline.json> [--update-baseline]]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "scene.hpp"
+
+#ifdef _WIN32
+#include <psapi.h>  // after windows.h, which scene.hpp includes
+#else
+#include <sys/resource.h>
+#endif
+
+namespace ranges = std::ranges;
+
+const char* const BENCH_NAME = "mini-vk-bench";
+const uint32_t BENCH_API_VERSION = VK_MAKE_API_VERSION(0, 1, 2, 0);  // the same as mini-vk
+const vk::Extent2D BENCH_EXTENT{1280, 720};
+const auto BENCH_COLOR_FORMAT = vk::Format::eR8G8B8A8Srgb;  // one that mini-vk prefers for its swapchain; NOTE: guaranteed
+                                                            // to support eColorAttachment
+const uint32_t BENCH_WARMUP_ITERATIONS = 10;  // not measured; lets lazy initialization in the driver happen first
+const uint32_t BENCH_SCENE_LOAD_COUNT = 20;
+const uint32_t BENCH_FRAME_COUNT = 300;
+const uint32_t BENCH_INSTANCE_GRID_SIZE = 128;  // 16384 instances, each small enough to stay cheap for software rasterizers
+const uint32_t BENCH_PIPELINE_COMPILE_COUNT = 20;
+const uint32_t BENCH_SWAPCHAIN_RECREATION_COUNT = 50;
+const double BENCH_DEFAULT_TOLERANCE = 0.5;  // for metrics new to the baseline when updating it
+const int BENCH_SKIP_RETURN_CODE = 77;       // no usable Vulkan implementation; CTest reports the test as skipped
+
+using BenchClock = std::chrono::steady_clock;
+
+// Counts of the host allocations made by the Vulkan implementation; atomic, as drivers may allocate from their own
+// threads (like lavapipe's queue thread)
+struct BenchAllocationStats {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> reallocations{0};
+};
+BenchAllocationStats BENCH_ALLOCATION_STATS;
+
+// APP_ALLOCATION_CALLBACKS plus counting, kept out of mini-vk so that it doesn't pay for the atomics
+const vk::AllocationCallbacks BENCH_ALLOCATION_CALLBACKS{
+    .pUserData = &BENCH_ALLOCATION_STATS,
+    .pfnAllocation =
+        [](void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope) {
+            static_cast<BenchAllocationStats*>(pUserData)->allocations.fetch_add(1, std::memory_order_relaxed);
+            return APP_ALLOCATION_CALLBACKS.pfnAllocation(nullptr, size, alignment, allocationScope);
+        },
+    .pfnReallocation =
+        [](void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocationScope) {
+            static_cast<BenchAllocationStats*>(pUserData)->reallocations.fetch_add(1, std::memory_order_relaxed);
+            return APP_ALLOCATION_CALLBACKS.pfnReallocation(nullptr, pOriginal, size, alignment, allocationScope);
+        },
+    .pfnFree = [](void* /*pUserData*/, void* pMemory) { APP_ALLOCATION_CALLBACKS.pfnFree(nullptr, pMemory); }};
+
+// A group of metrics, like a scene; all metrics are lower-is-better
+struct BenchGroup {
+    std::string name;
+    std::optional<std::string> skipped;  // the reason, if the group couldn't run
+    uint32_t iterations = 0;
+    std::vector<std::pair<std::string, std::optional<double>>> metrics;  // nullopt when not measurable on this device
+};
+
+// What the baseline is keyed on. The name is only informational, as it embeds driver details that toolchain updates
+// change (like llvmpipe's LLVM version), while the IDs stay the same.
+struct BenchDeviceIdentity {
+    std::string name;
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+    uint32_t driverId = 0;  // a VkDriverId
+};
+
+// Just enough JSON to read the baseline back: objects, numbers, strings and null
+struct Json {
+    enum class Type { eNull, eNumber, eString, eObject } type = Type::eNull;
+    double number = 0.0;
+    std::string string;
+    std::vector<std::pair<std::string, Json>> members;  // in file order
+
+    [[nodiscard]] const Json* find(std::string_view key) const {
+        auto it = ranges::find_if(members, [key](auto&& member) { return member.first == key; });
+        return it == members.end() ? nullptr : &it->second;
+    }
+};
+
+class JsonParser {
+   public:
+    explicit JsonParser(std::string_view text) : text_{text} {}
+
+    [[nodiscard]] Json parse() {
+        auto value = parseValue();
+        skipWhitespace();
+        if (position_ != text_.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+   private:
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Invalid JSON at offset " + std::to_string(position_) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (position_ < text_.size() && std::strchr(" \t\r\n", text_[position_])) {
+            ++position_;
+        }
+    }
+
+    void expect(char c) {
+        skipWhitespace();
+        if (position_ >= text_.size() || text_[position_] != c) {
+            fail(std::string{"expected '"} + c + "'");
+        }
+        ++position_;
+    }
+
+    [[nodiscard]] std::string parseString() {
+        expect('"');
+        std::string result;
+        while (position_ < text_.size() && text_[position_] != '"') {
+            if (text_[position_] == '\\' && position_ + 1 < text_.size()) {
+                ++position_;  // NOTE: \uXXXX escapes aren't supported
+            }
+            result += text_[position_++];
+        }
+        expect('"');
+        return result;
+    }
+
+    [[nodiscard]] Json parseValue() {
+        skipWhitespace();
+        if (position_ >= text_.size()) {
+            fail("unexpected end");
+        }
+        Json value;
+        if (text_[position_] == '{') {
+            ++position_;
+            value.type = Json::Type::eObject;
+            skipWhitespace();
+            if (position_ < text_.size() && text_[position_] == '}') {
+                ++position_;
+                return value;
+            }
+            do {
+                auto key = parseString();
+                expect(':');
+                value.members.emplace_back(std::move(key), parseValue());
+                skipWhitespace();
+            } while (position_ < text_.size() && text_[position_] == ',' && ++position_);
+            expect('}');
+        } else if (text_[position_] == '"') {
+            value.type = Json::Type::eString;
+            value.string = parseString();
+        } else if (text_.substr(position_, 4) == "null") {
+            position_ += 4;
+        } else {
+            const char* begin = text_.data() + position_;
+            char* end;
+            value.type = Json::Type::eNumber;
+            value.number = std::strtod(begin, &end);  // NOTE: the text is null-terminated, as it comes from a std::string
+            if (end == begin) {
+                fail("expected a value");
+            }
+            position_ += end - begin;
+        }
+        return value;
+    }
+
+    std::string_view text_;
+    size_t position_ = 0;
+};
+
+[[nodiscard]] uint64_t host_allocation_count() {
+    return BENCH_ALLOCATION_STATS.allocations.load(std::memory_order_relaxed) +
+           BENCH_ALLOCATION_STATS.reallocations.load(std::memory_order_relaxed);
+}
+
+// The peak resident set size of the process so far
+[[nodiscard]] double peak_rss_mib() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{.cb = sizeof(counters)};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<double>(counters.PeakWorkingSetSize) / (1 << 20);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<double>(usage.ru_maxrss) / (1 << 20);  // in bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / (1 << 10);  // in KiB
+#endif
+#endif
+}
+
+[[nodiscard]] double milliseconds_since(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+// What one iteration measured itself
+struct BenchSample {
+    std::optional<double> cpuMs;  // for when only part of the iteration is CPU work; the whole iteration otherwise
+    std::optional<double> gpuMs;  // when it could be measured
+};
+
+// Runs `iteration` `warmupCount` times, then `count` measured times, each after an unmeasured `setup`
+template <typename S, typename F>
+[[nodiscard]] BenchGroup measure(const char* name, uint32_t count, uint32_t warmupCount, S&& setup, F&& iteration) {
+    for (uint32_t i = 0; i < warmupCount; ++i) {
+        setup();
+        [[maybe_unused]] BenchSample sample = iteration();
+    }
+
+    std::vector<double> cpuMs, gpuMs;
+    cpuMs.reserve(count);
+    gpuMs.reserve(count);
+    uint64_t allocations = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        setup();
+        auto allocationsBefore = host_allocation_count();
+        auto start = BenchClock::now();
+        BenchSample sample = iteration();
+        cpuMs.push_back(sample.cpuMs ? *sample.cpuMs : milliseconds_since(start));
+        allocations += host_allocation_count() - allocationsBefore;
+        if (sample.gpuMs) {
+            gpuMs.push_back(*sample.gpuMs);
+        }
+    }
+
+    auto percentile = [](std::vector<double> samples, size_t percent) -> std::optional<double> {
+        if (samples.empty()) {
+            return std::nullopt;
+        }
+        ranges::sort(samples);
+        return samples[std::min(samples.size() - 1, samples.size() * percent / 100)];
+    };
+    return BenchGroup{.name = name,
+                      .skipped{},
+                      .iterations = count,
+                      .metrics{{"cpu_ms", percentile(cpuMs, 50)},
+                               {"cpu_ms_p95", percentile(cpuMs, 95)},
+                               {"gpu_ms", gpuMs.size() == count ? percentile(gpuMs, 50) : std::nullopt},
+                               {"host_allocations", static_cast<double>(allocations) / count}}};
+}
+
+template <typename F>
+[[nodiscard]] BenchGroup measure(const char* name, uint32_t count, F&& iteration) {
+    return measure(name, count, BENCH_WARMUP_ITERATIONS, []() {}, std::forward<F>(iteration));
+}
+
+[[nodiscard]] std::string json_string(std::string_view s) {
+    std::string result = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result + '"';
+}
+
+[[nodiscard]] std::string json_device_identity(const BenchDeviceIdentity& identity) {
+    return "{\"name\": " + json_string(identity.name) + ", \"vendor_id\": " + std::to_string(identity.vendorId) +
+           ", \"device_id\": " + std::to_string(identity.deviceId) + ", \"driver_id\": " + std::to_string(identity.driverId) +
+           '}';
+}
+
+void write_results(const std::filesystem::path& p,
+                   const BenchDeviceIdentity& deviceIdentity,
+                   const std::vector<BenchGroup>& groups) {
+    std::ofstream out{p, std::ios_base::out | std::ios_base::trunc};
+    if (!out.is_open()) {
+        throw std::runtime_error("Couldn't open file " + p.string());
+    }
+    out << std::setprecision(6) << "{\n    \"device\": " << json_device_identity(deviceIdentity);
+    for (auto&& group : groups) {
+        out << ",\n    " << json_string(group.name) << ": {";
+        if (group.skipped) {
+            out << "\"skipped\": " << json_string(*group.skipped) << '}';
+            continue;
+        }
+        out << "\"iterations\": " << group.iterations;
+        for (auto&& [metric, value] : group.metrics) {
+            out << ", " << json_string(metric) << ": ";
+            if (value) {
+                out << *value;
+            } else {
+                out << "null";
+            }
+        }
+        out << '}';
+    }
+    out << "\n}\n";
+}
+
+// Whether the baseline's "device" has the IDs of `deviceIdentity`
+[[nodiscard]] bool keyed_on(const Json& baseline, const BenchDeviceIdentity& deviceIdentity) {
+    auto&& device = baseline.find("device");
+    auto hasId = [&device](std::string_view key, uint32_t id) {
+        auto&& value = device->find(key);
+        return value && value->type == Json::Type::eNumber && value->number == id;
+    };
+    return device && device->type == Json::Type::eObject && hasId("vendor_id", deviceIdentity.vendorId) &&
+           hasId("device_id", deviceIdentity.deviceId) && hasId("driver_id", deviceIdentity.driverId);
+}
+
+// Whether the baseline has metrics recorded on `deviceIdentity`, so that its limits mean something here
+[[nodiscard]] bool recorded_on(const Json& baseline, const BenchDeviceIdentity& deviceIdentity) {
+    auto isGroup = [](auto&& member) { return member.first != "device"; };
+    return keyed_on(baseline, deviceIdentity) && ranges::any_of(baseline.members, isGroup);
+}
+
+// For when there is no baseline to compare against
+void print_results(const std::vector<BenchGroup>& groups) {
+    for (auto&& group : groups) {
+        if (group.skipped) {
+            std::cout << group.name << ": not run (" << *group.skipped << ")\n";
+            continue;
+        }
+        for (auto&& [metric, value] : group.metrics) {
+            std::cout << group.name << '.' << metric << ": ";
+            if (value) {
+                std::cout << *value << '\n';
+            } else {
+                std::cout << "not measured\n";
+            }
+        }
+    }
+}
+
+// Every baseline metric is {"baseline": <value>, "tolerance": <fraction>} and regresses when the measured value exceeds
+// baseline * (1 + tolerance). Metrics that weren't measured (skipped scenes, no timestamp support...) aren't gated. The
+// baseline has to be recorded_on() this device.
+[[nodiscard]] bool check_baseline(const Json& baseline, const std::vector<BenchGroup>& groups) {
+    bool passed = true;
+    for (auto&& [groupName, expectedMetrics] : baseline.members) {
+        if (groupName == "device") {
+            continue;
+        }
+        auto group = ranges::find(groups, groupName, &BenchGroup::name);
+        if (group == groups.end() || group->skipped) {
+            std::cout << groupName << ": not run" << (group != groups.end() ? " (" + *group->skipped + ")" : "") << '\n';
+            continue;
+        }
+        for (auto&& [metricName, expected] : expectedMetrics.members) {
+            auto metric = ranges::find(group->metrics, metricName, &decltype(group->metrics)::value_type::first);
+            auto&& baselineValue = expected.find("baseline");
+            auto&& tolerance = expected.find("tolerance");
+            if (!baselineValue || !tolerance) {
+                throw std::runtime_error("Baseline metric " + groupName + "." + metricName + " lacks baseline or tolerance");
+            }
+            std::cout << groupName << '.' << metricName << ": ";
+            if (metric == group->metrics.end() || !metric->second) {
+                std::cout << "not measured\n";
+                continue;
+            }
+            double limit = baselineValue->number * (1.0 + tolerance->number);
+            bool regressed = *metric->second > limit;
+            passed = passed && !regressed;
+            std::cout << *metric->second << " (baseline " << baselineValue->number << ", limit " << limit << ")"
+                      << (regressed ? " REGRESSION" : "") << '\n';
+        }
+    }
+    return passed;
+}
+
+// Replaces the baseline values and device with the measured ones, keeping the tolerances and, if the device is the same,
+// the groups that didn't run here
+void update_baseline(const std::filesystem::path& p,
+                     const Json& baseline,
+                     const BenchDeviceIdentity& deviceIdentity,
+                     const std::vector<BenchGroup>& groups) {
+    // p95s are too noisy to gate, and so is startup's ms, which is a single sample
+    const std::array gatedMetrics{"cpu_ms", "gpu_ms", "host_allocations", "peak_rss_mib"};
+
+    std::ostringstream out;
+    out << std::setprecision(6) << "{\n    \"device\": " << json_device_identity(deviceIdentity);
+    auto writeGroupHeader = [&out](std::string_view name) { out << ",\n    " << json_string(name) << ": {"; };
+    bool sameDevice = keyed_on(baseline, deviceIdentity);
+    for (auto&& group : groups) {
+        auto&& previous = baseline.find(group.name);
+        if (group.skipped) {
+            if (previous && sameDevice) {  // keep what was measured where the group could run
+                writeGroupHeader(group.name);
+                for (bool firstMetric = true; auto&& [metric, value] : previous->members) {
+                    out << (firstMetric ? "\n" : ",\n") << "        " << json_string(metric)
+                        << ": {\"baseline\": " << value.find("baseline")->number
+                        << ", \"tolerance\": " << value.find("tolerance")->number << '}';
+                    firstMetric = false;
+                }
+                out << "\n    }";
+            }
+            continue;
+        }
+        writeGroupHeader(group.name);
+        bool firstMetric = true;
+        for (auto&& [metric, value] : group.metrics) {
+            if (!value || !ranges::any_of(gatedMetrics, [&metric](const char* gated) { return metric == gated; })) {
+                continue;
+            }
+            auto&& previousMetric = previous ? previous->find(metric) : nullptr;
+            auto&& previousTolerance = previousMetric ? previousMetric->find("tolerance") : nullptr;
+            out << (firstMetric ? "\n" : ",\n") << "        " << json_string(metric) << ": {\"baseline\": " << *value
+                << ", \"tolerance\": " << (previousTolerance ? previousTolerance->number : BENCH_DEFAULT_TOLERANCE) << '}';
+            firstMetric = false;
+        }
+        out << "\n    }";
+    }
+    out << "\n}\n";
+
+    std::ofstream file{p, std::ios_base::out | std::ios_base::trunc};
+    if (!file.is_open()) {
+        throw std::runtime_error("Couldn't open file " + p.string());
+    }
+    file << out.str();
+}
+
+int main(int argc, char** argv) {
+    bool updateBaseline = argc == 4 && std::string_view{argv[3]} == "--update-baseline";
+    if (argc < 2 || argc > 4 || (argc == 4 && !updateBaseline)) {
+        std::cerr << "Usage: " << argv[0] << " <results.json> [<baseline.json> [--update-baseline]]\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto startupBegin = BenchClock::now();
+        auto startupAllocationsBefore = host_allocation_count();
+
+        std::unique_ptr<vk::DynamicLoader> dl;
+        try {
+            dl = std::make_unique<vk::DynamicLoader>();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Skipping, as there is no Vulkan loader: " << e.what() << '\n';
+            return BENCH_SKIP_RETURN_CODE;
+        }
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(dl->getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr"));
+
+        // The swapchain scene needs a surface; a headless one is used, where available, to stay independent of any
+        // windowing system
+        auto hasExtension = [](auto&& extensions, const char* name) {
+            return ranges::any_of(extensions, [name](auto&& extension) { return strcmp(extension.extensionName, name) == 0; });
+        };
+        auto instanceExtensions = [&hasExtension]() {
+            auto available = vk::enumerateInstanceExtensionProperties();
+            std::vector<const char*> extensions;
+            if (hasExtension(available, VK_KHR_SURFACE_EXTENSION_NAME) &&
+                hasExtension(available, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME)) {
+                extensions = {VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+            }
+            return extensions;
+        }();
+
+        vk::ApplicationInfo appInfo{.pApplicationName = BENCH_NAME,
+                                    .applicationVersion = 1,
+                                    .pEngineName = BENCH_NAME,
+                                    .engineVersion = 1,
+                                    .apiVersion = BENCH_API_VERSION};
+        vk::Instance instance;
+        try {
+            instance = vk::createInstance(  // NOTE: no validation layers, as they would dominate the measurements
+                vk::InstanceCreateInfo{.pApplicationInfo = &appInfo,
+                                       .enabledExtensionCount = static_cast<uint32_t>(instanceExtensions.size()),
+                                       .ppEnabledExtensionNames = instanceExtensions.data()},
+                BENCH_ALLOCATION_CALLBACKS);
+        } catch (const vk::IncompatibleDriverError& e) {
+            std::cerr << "Skipping, as there is no Vulkan driver: " << e.what() << '\n';
+            return BENCH_SKIP_RETURN_CODE;
+        }
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(instance);
+
+        auto [physicalDevice, graphicsFamilyIdx] = [&instance]() -> std::tuple<vk::PhysicalDevice, std::optional<uint32_t>> {
+            for (auto&& physicalDevice : instance.enumeratePhysicalDevices()) {
+                if (physicalDevice.getProperties().apiVersion < BENCH_API_VERSION) {
+                    continue;
+                }
+                auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+                for (uint32_t i = 0; i < queueFamilies.size(); ++i) {
+                    if (queueFamilies[i].queueFlags & vk::QueueFlagBits::eGraphics) {
+                        return {physicalDevice, i};
+                    }
+                }
+            }
+            return {vk::PhysicalDevice{}, std::nullopt};
+        }();
+        if (!graphicsFamilyIdx) {
+            std::cerr << "Skipping, as there is no Vulkan 1.2 device with a graphics queue\n";
+            instance.destroy(BENCH_ALLOCATION_CALLBACKS);
+            return BENCH_SKIP_RETURN_CODE;
+        }
+        auto properties = physicalDevice.getProperties();
+        auto driverProperties =
+            physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDriverProperties>()
+                .get<vk::PhysicalDeviceDriverProperties>();
+        BenchDeviceIdentity deviceIdentity{.name = properties.deviceName.data(),
+                                           .vendorId = properties.vendorID,
+                                           .deviceId = properties.deviceID,
+                                           .driverId = static_cast<uint32_t>(driverProperties.driverID)};
+        auto timestampValidBits = physicalDevice.getQueueFamilyProperties()[*graphicsFamilyIdx].timestampValidBits;
+
+        bool swapchainSupported =
+            !instanceExtensions.empty() &&
+            hasExtension(physicalDevice.enumerateDeviceExtensionProperties(), VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        std::vector<const char*> deviceExtensions;
+        if (swapchainSupported) {
+            deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+        // the same features as mini-vk enables
+        vk::PhysicalDeviceFeatures features{.textureCompressionBC = physicalDevice.getFeatures().textureCompressionBC};
+        float queuePriority = 1.0f;
+        vk::DeviceQueueCreateInfo queueCreateInfo{
+            .queueFamilyIndex = *graphicsFamilyIdx, .queueCount = 1, .pQueuePriorities = &queuePriority};
+        auto device = physicalDevice.createDevice({.queueCreateInfoCount = 1,
+                                                   .pQueueCreateInfos = &queueCreateInfo,
+                                                   .enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
+                                                   .ppEnabledExtensionNames = deviceExtensions.data(),
+                                                   .pEnabledFeatures = &features});
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(device);
+        auto graphicsQueue = device.getQueue(*graphicsFamilyIdx, 0);
+
+        // mini-vk's scene, set up by the same code as in mini-vk
+        SamplerCache samplerCache{device};
+        Bc1Compressor bc1Compressor{physicalDevice, device, *graphicsFamilyIdx, samplerCache};
+        auto [meshBuffer, meshBufferMemory, meshIndexBufferOffset, meshIndexType, meshEntries] =
+            load_meshes(physicalDevice, device, graphicsQueue, *graphicsFamilyIdx, APP_MESH_PATH);
+        auto [textureImage, textureImageMemory, textureImageView] =
+            create_texture(physicalDevice, device, graphicsQueue, *graphicsFamilyIdx, bc1Compressor);
+        auto textureDescriptorSetLayout = create_texture_descriptor_set_layout(device);
+        auto [descriptorPool, textureDescriptorSet] =
+            create_texture_descriptor_set(device, textureDescriptorSetLayout, samplerCache, textureImageView);
+
+        // Offscreen render target, in place of the swapchain images
+        auto memoryProperties = physicalDevice.getMemoryProperties();
+        auto colorImage = device.createImage({.imageType = vk::ImageType::e2D,
+                                              .format = BENCH_COLOR_FORMAT,
+                                              .extent = {BENCH_EXTENT.width, BENCH_EXTENT.height, 1},
+                                              .mipLevels = 1,
+                                              .arrayLayers = 1,
+                                              .samples = APP_SAMPLE_COUNT,
+                                              .tiling = vk::ImageTiling::eOptimal,
+                                              .usage = vk::ImageUsageFlagBits::eColorAttachment,
+                                              .sharingMode = vk::SharingMode::eExclusive,
+                                              .initialLayout = vk::ImageLayout::eUndefined});
+        auto colorImageMemory = allocate_memory(device, memoryProperties, device.getImageMemoryRequirements(colorImage),
+                                                vk::MemoryPropertyFlagBits::eDeviceLocal);
+        device.bindImageMemory(colorImage, colorImageMemory, 0);
+        auto colorImageView = device.createImageView({.image = colorImage,
+                                                      .viewType = vk::ImageViewType::e2D,
+                                                      .format = BENCH_COLOR_FORMAT,
+                                                      .components{},
+                                                      .subresourceRange{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                                        .baseMipLevel = 0,
+                                                                        .levelCount = 1,
+                                                                        .baseArrayLayer = 0,
+                                                                        .layerCount = 1}});
+        auto renderPass = create_render_pass(device, BENCH_COLOR_FORMAT, vk::ImageLayout::eColorAttachmentOptimal);
+        auto framebuffer = device.createFramebuffer({.renderPass = renderPass,
+                                                     .attachmentCount = 1,
+                                                     .pAttachments = &colorImageView,
+                                                     .width = BENCH_EXTENT.width,
+                                                     .height = BENCH_EXTENT.height,
+                                                     .layers = 1});
+
+        auto vertexShaderModule = create_shader_module(device, APP_VERTEX_SHADER_PATH);
+        auto fragmentShaderModule = create_shader_module(device, APP_FRAGMENT_SHADER_PATH);
+        auto pipelineLayout = create_graphics_pipeline_layout(device, textureDescriptorSetLayout);
+        auto createPipeline = [&device, &renderPass, &pipelineLayout, &vertexShaderModule,
+                               &fragmentShaderModule](vk::PipelineCache pipelineCache) {
+            return create_graphics_pipeline(device, BENCH_EXTENT, renderPass, pipelineLayout, vertexShaderModule,
+                                            fragmentShaderModule, pipelineCache);
+        };
+        auto pipeline = createPipeline(VK_NULL_HANDLE);
+
+        auto commandPool = device.createCommandPool(
+            {.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = *graphicsFamilyIdx});
+        auto commandBuffer = device.allocateCommandBuffers(
+            {.commandPool = commandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1})[0];
+        auto fence = device.createFence(vk::FenceCreateInfo{});
+        vk::QueryPool queryPool = VK_NULL_HANDLE;  // stays null when the queue doesn't support timestamps
+        if (timestampValidBits > 0) {
+            queryPool = device.createQueryPool({.queryType = vk::QueryType::eTimestamp, .queryCount = 2});
+        }
+
+        // Startup is everything up to being able to render the first frame
+        std::vector<BenchGroup> groups{
+            BenchGroup{.name = "startup",
+                       .skipped{},
+                       .iterations = 1,
+                       .metrics{{"ms", milliseconds_since(startupBegin)},
+                                {"host_allocations", static_cast<double>(host_allocation_count() - startupAllocationsBefore)},
+                                {"peak_rss_mib", peak_rss_mib()}}}};
+
+        // Loading the scene again, as mini-vk does at startup: the mapped mesh upload, the mip chain blits and the BC1
+        // compression (where supported)
+        groups.push_back(measure("scene_load", BENCH_SCENE_LOAD_COUNT, [&]() -> BenchSample {
+            auto meshes = load_meshes(physicalDevice, device, graphicsQueue, *graphicsFamilyIdx, APP_MESH_PATH);
+            auto texture = create_texture(physicalDevice, device, graphicsQueue, *graphicsFamilyIdx, bc1Compressor);
+            device.destroy(std::get<2>(texture));
+            device.destroy(std::get<0>(texture));
+            device.freeMemory(std::get<1>(texture));
+            device.destroy(std::get<0>(meshes));
+            device.freeMemory(std::get<1>(meshes));
+            return {};
+        }));
+        groups.back().metrics.emplace_back("peak_rss_mib", peak_rss_mib());
+
+        // One fully synchronous frame: record, submit, wait. Its CPU time is only the recording and submission, so that it
+        // isn't hidden behind the GPU's, which the timestamps measure.
+        auto renderFrame = [&](std::span<const MeshFileEntry> meshes) -> BenchSample {
+            auto start = BenchClock::now();
+            commandBuffer.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+            if (queryPool) {
+                commandBuffer.resetQueryPool(queryPool, 0, 2);
+                commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, queryPool, 0);
+            }
+            record_scene(commandBuffer, renderPass, framebuffer, BENCH_EXTENT, pipeline, pipelineLayout, textureDescriptorSet,
+                         meshBuffer, meshIndexBufferOffset, meshIndexType, meshes);
+            if (queryPool) {
+                commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, queryPool, 1);
+            }
+            commandBuffer.end();
+
+            graphicsQueue.submit(vk::SubmitInfo{.commandBufferCount = 1, .pCommandBuffers = &commandBuffer}, fence);
+            double cpuMs = milliseconds_since(start);
+            device.waitForFences(fence, true, std::numeric_limits<uint64_t>::max());
+            device.resetFences(fence);
+
+            if (!queryPool) {
+                return {.cpuMs = cpuMs, .gpuMs = std::nullopt};
+            }
+            std::array<uint64_t, 2> timestamps;
+            if (device.getQueryPoolResults(queryPool, 0, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t),
+                                           vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait) !=
+                vk::Result::eSuccess) {
+                return {.cpuMs = cpuMs, .gpuMs = std::nullopt};
+            }
+            uint64_t mask = timestampValidBits == 64 ? ~uint64_t{0} : (uint64_t{1} << timestampValidBits) - 1;
+            return {.cpuMs = cpuMs,
+                    .gpuMs = static_cast<double>((timestamps[1] - timestamps[0]) & mask) *
+                             properties.limits.timestampPeriod / 1e6};
+        };
+
+        // Instances of the scene on a grid, each scaled down into its own cell through the bounds it is drawn with, so
+        // that they don't overlap; NOTE: each one is a draw, as basic.vert has no per-instance data to offset them by
+        std::vector<MeshFileEntry> instances;
+        float cellSize = 2.0f / BENCH_INSTANCE_GRID_SIZE;
+        for (uint32_t y = 0; y < BENCH_INSTANCE_GRID_SIZE; ++y) {
+            for (uint32_t x = 0; x < BENCH_INSTANCE_GRID_SIZE; ++x) {
+                std::array cellMin{-1.0f + x * cellSize, -1.0f + y * cellSize};
+                for (auto mesh : meshEntries) {
+                    for (size_t j = 0; j < cellMin.size(); ++j) {  // the scene's [-1, 1] maps onto the cell
+                        mesh.bounds.min[j] = cellMin[j] + (mesh.bounds.min[j] + 1.0f) * 0.5f * cellSize;
+                        mesh.bounds.max[j] = cellMin[j] + (mesh.bounds.max[j] + 1.0f) * 0.5f * cellSize;
+                    }
+                    instances.push_back(mesh);
+                }
+            }
+        }
+
+        groups.push_back(measure("empty_frame", BENCH_FRAME_COUNT, [&renderFrame]() { return renderFrame({}); }));
+        groups.push_back(
+            measure("scene_frame", BENCH_FRAME_COUNT, [&renderFrame, &meshEntries]() { return renderFrame(meshEntries); }));
+        groups.push_back(
+            measure("many_instances", BENCH_FRAME_COUNT, [&renderFrame, &instances]() { return renderFrame(instances); }));
+
+        // Every cold compile is on a new device, as drivers keep in-memory pipeline caches per device, and has no warm-up,
+        // which would only fill those; NOTE: drivers may also keep on-disk caches, which CTest disables for Mesa and NVIDIA
+        struct {
+            vk::Device device;
+            vk::RenderPass renderPass;
+            vk::DescriptorSetLayout descriptorSetLayout;
+            vk::PipelineLayout pipelineLayout;
+            vk::ShaderModule vertexShaderModule;
+            vk::ShaderModule fragmentShaderModule;
+        } cold{};
+        auto destroyColdDevice = [&cold]() {
+            if (!cold.device) {
+                return;
+            }
+            cold.device.destroy(cold.vertexShaderModule);
+            cold.device.destroy(cold.fragmentShaderModule);
+            cold.device.destroy(cold.pipelineLayout);
+            cold.device.destroy(cold.descriptorSetLayout);
+            cold.device.destroy(cold.renderPass);
+            cold.device.destroy();
+            cold = {};
+        };
+        groups.push_back(measure(
+            "pipeline_cold_compile", BENCH_PIPELINE_COMPILE_COUNT, 0,
+            [&]() {
+                destroyColdDevice();
+                cold.device = physicalDevice.createDevice({.queueCreateInfoCount = 1, .pQueueCreateInfos = &queueCreateInfo});
+                VULKAN_HPP_DEFAULT_DISPATCHER.init(cold.device);  // device functions are loaded per device
+                cold.renderPass = create_render_pass(cold.device, BENCH_COLOR_FORMAT, vk::ImageLayout::eColorAttachmentOptimal);
+                cold.descriptorSetLayout = create_texture_descriptor_set_layout(cold.device);
+                cold.pipelineLayout = create_graphics_pipeline_layout(cold.device, cold.descriptorSetLayout);
+                cold.vertexShaderModule = create_shader_module(cold.device, APP_VERTEX_SHADER_PATH);
+                cold.fragmentShaderModule = create_shader_module(cold.device, APP_FRAGMENT_SHADER_PATH);
+            },
+            [&cold]() -> BenchSample {
+                cold.device.destroy(create_graphics_pipeline(cold.device, BENCH_EXTENT, cold.renderPass, cold.pipelineLayout,
+                                                             cold.vertexShaderModule, cold.fragmentShaderModule,
+                                                             VK_NULL_HANDLE));
+                return {};
+            }));
+        destroyColdDevice();
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(device);
+
+        auto warmPipelineCache = device.createPipelineCache({});
+        device.destroy(createPipeline(warmPipelineCache));
+        groups.push_back(measure("pipeline_warm_compile", BENCH_PIPELINE_COMPILE_COUNT,
+                                 [&device, &createPipeline, &warmPipelineCache]() -> BenchSample {
+                                     device.destroy(createPipeline(warmPipelineCache));
+                                     return {};
+                                 }));
+        device.destroy(warmPipelineCache);
+
+        groups.push_back([&]() {
+            if (!swapchainSupported) {
+                return BenchGroup{.name = "swapchain_recreation",
+                                  .skipped = "VK_EXT_headless_surface or VK_KHR_swapchain is not supported",
+                                  .iterations = 0,
+                                  .metrics{}};
+            }
+            auto surface = instance.createHeadlessSurfaceEXT(vk::HeadlessSurfaceCreateInfoEXT{});
+            if (!physicalDevice.getSurfaceSupportKHR(*graphicsFamilyIdx, surface)) {
+                instance.destroy(surface);
+                return BenchGroup{.name = "swapchain_recreation",
+                                  .skipped = "The headless surface can't be presented to",
+                                  .iterations = 0,
+                                  .metrics{}};
+            }
+            auto surfaceFormat = physicalDevice.getSurfaceFormatsKHR(surface)[0];
+            auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(surface);
+
+            uint32_t imageCount = std::clamp(3u, surfaceCapabilities.minImageCount,  // as in mini-vk
+                                             (surfaceCapabilities.maxImageCount == 0 ? std::numeric_limits<uint32_t>::max()
+                                                                                     : surfaceCapabilities.maxImageCount));
+
+            vk::SwapchainKHR swapchain = VK_NULL_HANDLE;
+            std::vector<vk::ImageView> swapchainImageViews;
+            uint32_t recreations = 0;
+            auto group = measure(
+                "swapchain_recreation", BENCH_SWAPCHAIN_RECREATION_COUNT, [&]() -> BenchSample {
+                    // alternate between two sizes, like a window being resized, unless the surface dictates one
+                    auto extent = surfaceCapabilities.currentExtent;
+                    if (extent.width == std::numeric_limits<uint32_t>::max()) {
+                        extent = vk::Extent2D{
+                            std::clamp(BENCH_EXTENT.width + recreations % 2, surfaceCapabilities.minImageExtent.width,
+                                       surfaceCapabilities.maxImageExtent.width),
+                            std::clamp(BENCH_EXTENT.height, surfaceCapabilities.minImageExtent.height,
+                                       surfaceCapabilities.maxImageExtent.height)};
+                    }
+                    ++recreations;
+
+                    auto oldSwapchain = swapchain;
+                    swapchain = device.createSwapchainKHR(
+                        {.surface = surface,
+                         .minImageCount = imageCount,
+                         .imageFormat = surfaceFormat.format,
+                         .imageColorSpace = surfaceFormat.colorSpace,
+                         .imageExtent = extent,
+                         .imageArrayLayers = 1,
+                         .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+                         .imageSharingMode = vk::SharingMode::eExclusive,
+                         .preTransform = surfaceCapabilities.currentTransform,
+                         .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
+                         .presentMode = vk::PresentModeKHR::eFifo,
+                         .clipped = true,
+                         .oldSwapchain = oldSwapchain});
+                    for (auto&& imageView : swapchainImageViews) {
+                        device.destroy(imageView);
+                    }
+                    swapchainImageViews.clear();
+                    if (oldSwapchain) {
+                        device.destroy(oldSwapchain);
+                    }
+
+                    for (auto&& image : device.getSwapchainImagesKHR(swapchain)) {
+                        swapchainImageViews.push_back(
+                            device.createImageView({.image = image,
+                                                    .viewType = vk::ImageViewType::e2D,
+                                                    .format = surfaceFormat.format,
+                                                    .components{},
+                                                    .subresourceRange{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                                      .baseMipLevel = 0,
+                                                                      .levelCount = 1,
+                                                                      .baseArrayLayer = 0,
+                                                                      .layerCount = 1}}));
+                    }
+                    return {};
+                });
+
+            for (auto&& imageView : swapchainImageViews) {
+                device.destroy(imageView);
+            }
+            device.destroy(swapchain);
+            instance.destroy(surface);
+            return group;
+        }());
+
+        // Cleanup
+        if (queryPool) {
+            device.destroy(queryPool);
+        }
+        device.destroy(fence);
+        device.destroy(commandPool);
+        device.destroy(pipeline);
+        device.destroy(pipelineLayout);
+        device.destroy(vertexShaderModule);
+        device.destroy(fragmentShaderModule);
+        device.destroy(framebuffer);
+        device.destroy(renderPass);
+        device.destroy(colorImageView);
+        device.destroy(colorImage);
+        device.freeMemory(colorImageMemory);
+        device.destroy(descriptorPool);
+        device.destroy(textureDescriptorSetLayout);
+        device.destroy(textureImageView);
+        device.destroy(textureImage);
+        device.freeMemory(textureImageMemory);
+        bc1Compressor.destroy();
+        samplerCache.destroy();
+        device.destroy(meshBuffer);
+        device.freeMemory(meshBufferMemory);
+        device.destroy();
+        instance.destroy(BENCH_ALLOCATION_CALLBACKS);
+
+        std::cout << "Device: " << deviceIdentity.name << '\n';
+        write_results(argv[1], deviceIdentity, groups);
+        if (argc == 2) {
+            return EXIT_SUCCESS;
+        }
+
+        std::ifstream baselineFile{argv[2]};
+        if (!baselineFile.is_open()) {
+            throw std::runtime_error(std::string{"Couldn't open file "} + argv[2]);
+        }
+        std::string baselineText{std::istreambuf_iterator<char>{baselineFile}, std::istreambuf_iterator<char>{}};
+        auto baseline = JsonParser{baselineText}.parse();
+        if (updateBaseline) {
+            update_baseline(argv[2], baseline, deviceIdentity, groups);
+            return EXIT_SUCCESS;
+        }
+        if (!recorded_on(baseline, deviceIdentity)) {
+            print_results(groups);
+            std::cerr << "Skipping the comparison, as the baseline has no metrics recorded on this device (vendor "
+                      << deviceIdentity.vendorId << ", device " << deviceIdentity.deviceId << ", driver "
+                      << deviceIdentity.driverId << "); record them with mini-vk-bench-update-baseline\n";
+            return BENCH_SKIP_RETURN_CODE;
+        }
+        if (!check_baseline(baseline, groups)) {
+            std::cerr << "Performance regressed beyond the baseline's tolerances\n";
+            return EXIT_FAILURE;
+        }
+    } catch (const vk::Error& e) {
+        std::cerr << "Vulkan error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,15 +1,6 @@
 #include <mimalloc-new-delete.h>  // override all allocations with the optimized mimalloc allocator library; NOTE: consider calling mi_option_set for some performance tweaks
 
-#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1  // load Vulkan dynamically rather than statically
-#define VULKAN_HPP_NO_CONSTRUCTORS            // use C++20's designated initializers
-#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS     // as above; NOTE: for compatibility
-                                              // with older SDKs
-#define VULKAN_HPP_NO_SETTERS                 // disable setter methods as unneeded and
-                                              // unnecessarily extending compilation time
-#define VULKAN_HPP_HAS_SPACESHIP_OPERATOR     // use C++20's spaceship operator;
-                                              // NOTE: for compatibility with older
-                                              // SDKs
-#include <vulkan/vulkan.hpp>  // use the C++ bindings for Vulkan instead of the C headers; NOTE: there is also a higher level wrapper called vulkan_raii.hpp with a different interface
+#include "vulkan_common.hpp"
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE  // has to be defined exactly
                                                     // once when using
                                                     // VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
@@ -19,6 +10,7 @@ VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE  // has to be defined exactly
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -26,6 +18,8 @@ VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE  // has to be defined exactly
 #include <tuple>
 #include <type_traits>
 
+#include "scene.hpp"
+
     namespace ranges = std::ranges;
 
 // Shortcuts
@@ -58,42 +52,6 @@ const auto APP_LAYERS =
 #endif
 
 const std::array APP_DEVICE_EXTENSIONS{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-const vk::AllocationCallbacks APP_ALLOCATION_CALLBACKS{
-    // NOTE: consider not using allocation callbacks as the performance
-    // gain/loss hasn't been measured. They are intended for logging rather than
-    // for a performance gain.
-    .pUserData = nullptr,
-    .pfnAllocation =
-        [](void* /*pUserData*/, size_t size, size_t alignment, VkSystemAllocationScope /*allocationScope*/) {
-            return mi_malloc_aligned(size, alignment);
-        },
-    .pfnReallocation =
-        [](void* /*pUserData*/, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope /*allocationScope*/) {
-            return mi_realloc_aligned(pOriginal, size, alignment);
-        },
-    .pfnFree = [](void* /*pUserData*/, void* pMemory) { mi_free(pMemory); }
-    // NOTE: callbacks can be installed for internal allocations. They are only
-    // callbacks that will notify the application that the Vulkan implementation
-    // performed an allocation using its own mechanisms.
-};
-const char* const APP_VERTEX_SHADER_PATH = "basic.vert.spv";
-const char* const APP_VERTEX_SHADER_ENTRY_POINT = "main";
-const char* const APP_FRAGMENT_SHADER_PATH = "basic.frag.spv";
-const char* const APP_FRAGMENT_SHADER_ENTRY_POINT = "main";
-const auto APP_SAMPLE_COUNT = vk::SampleCountFlagBits::e1;
-const uint32_t APP_GRAPHICS_PIPELINE_SUBPASS_INDEX = 0;
-const auto APP_SUBPASS_PIPELINE_BIND_POINT = vk::PipelineBindPoint::eGraphics;
-
-[[nodiscard]] auto read_binary_file(const std::filesystem::path& p) {
-    std::ifstream in{p, std::ios_base::in | std::ios_base::binary};
-    if (!in.is_open()) {
-        throw std::runtime_error("Couldn't open file " + p.string());
-    }
-    size_t sz = std::filesystem::file_size(p);  // can't throw as `p` exists
-    auto buffer = std::make_unique_for_overwrite<std::byte[]>(sz);
-    in.read(reinterpret_cast<char*>(buffer.get()), sz);
-    return std::tuple{std::move(buffer), sz};
-}
 
 int main() {
     try {
@@ -239,7 +197,11 @@ int main() {
                     .ppEnabledExtensionNames = APP_DEVICE_EXTENSIONS.data(),
                     .pEnabledFeatures = nullptr  // using PhysicalDeviceFeatures2 instead
                 },
-                vk::PhysicalDeviceFeatures2{.features = vk::PhysicalDeviceFeatures{}},
+                vk::PhysicalDeviceFeatures2{
+                    .features = vk::PhysicalDeviceFeatures{
+                        .textureCompressionBC = physicalDeviceGroup.physicalDevices[0]
+                                                    .getFeatures()
+                                                    .textureCompressionBC}},  // used for textures when available
                 vk::DeviceGroupDeviceCreateInfo{.physicalDeviceCount = physicalDeviceGroup.physicalDeviceCount,
                                                 .pPhysicalDevices = physicalDeviceGroup.physicalDevices}};
             auto device = physicalDeviceGroup.physicalDevices[0].createDevice(deviceCreateInfo.get());
@@ -254,6 +216,9 @@ int main() {
 
         VULKAN_HPP_DEFAULT_DISPATCHER.init(device);  // load device-specific function pointers
 
+        SamplerCache samplerCache{device};
+        Bc1Compressor bc1Compressor{physicalDeviceGroup.physicalDevices[0], device, graphicsFamilyIdx, samplerCache};
+
         auto commandPool = [&device, &graphicsFamilyIdx]() {
             vk::CommandPoolCreateInfo commandPoolCreateInfo{
                 .flags{},  // NOTE: often CommandPoolCreateFlagBits::eTransient is used (when recording cmdbufs frequently)
@@ -262,6 +227,17 @@ int main() {
             return device.createCommandPool(commandPoolCreateInfo);
         }();
 
+        // Load the scene; see scene.hpp
+        auto [meshBuffer, meshBufferMemory, meshIndexBufferOffset, meshIndexType, meshEntries] =
+            load_meshes(physicalDeviceGroup.physicalDevices[0], device, graphicsQueue, graphicsFamilyIdx, APP_MESH_PATH);
+
+        auto [textureImage, textureImageMemory, textureImageView] =
+            create_texture(physicalDeviceGroup.physicalDevices[0], device, graphicsQueue, graphicsFamilyIdx, bc1Compressor);
+
+        auto textureDescriptorSetLayout = create_texture_descriptor_set_layout(device);
+        auto [descriptorPool, textureDescriptorSet] =
+            create_texture_descriptor_set(device, textureDescriptorSetLayout, samplerCache, textureImageView);
+
         // Create swapchain with images
         auto [swapchain, swapchainImageFormat, swapchainImageExtent, swapchainImages,
               maxFramesInFlight] = [&physicalDeviceGroup, &surface, &graphicsFamilyIdx, &presentFamilyIdx, &window, &device]() {
@@ -408,59 +384,7 @@ int main() {
             return swapchainImageViews;
         }();
 
-        auto renderpass = [&device, &swapchainImageFormat]() {
-            auto attachments = {vk::AttachmentDescription2{
-                .format = swapchainImageFormat,
-                .samples = APP_SAMPLE_COUNT,
-                .loadOp = vk::AttachmentLoadOp::eDontCare,  // NOTE: can be used to clear image before rendering
-                .storeOp = vk::AttachmentStoreOp::eStore,
-                .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,  // NOTE: should be changed when using stencil buffers
-                .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-                .initialLayout = vk::ImageLayout::eUndefined,  // NOTE: can only be used in combination with LoadOp::eDontCare
-                .finalLayout = vk::ImageLayout::ePresentSrcKHR}};
-
-            vk::AttachmentReference2 mainColorAttachmentReference{
-                .attachment = 0,
-                .layout = vk::ImageLayout::eColorAttachmentOptimal,
-                .aspectMask{}};  // ignored, as it doesn't refer to an input attachment
-
-            auto subpasses = {vk::SubpassDescription2{
-                .pipelineBindPoint = APP_SUBPASS_PIPELINE_BIND_POINT,
-                .viewMask{},                // NOTE: to be used with multiview
-                .inputAttachmentCount = 0,  // NOTE: used to set input attachments
-                .pInputAttachments = nullptr,
-                .colorAttachmentCount = 1,
-                .pColorAttachments = &mainColorAttachmentReference,
-                .pResolveAttachments = nullptr,      // NOTE: has something to do with multisampling
-                .pDepthStencilAttachment = nullptr,  // NOTE: should be used with depth/stencil buffer
-                .preserveAttachmentCount = 0,        // NOTE: used for any attachments that are not accessed in this subpass, but
-                                                     // shouldn't have their contents invalidated
-                .pPreserveAttachments = 0}};
-
-            auto dependencies = {vk::SubpassDependency2{
-                .srcSubpass = VK_SUBPASS_EXTERNAL,  // operations before the first subpass
-                .dstSubpass = APP_GRAPHICS_PIPELINE_SUBPASS_INDEX,
-                .srcStageMask =
-                    vk::PipelineStageFlagBits::eColorAttachmentOutput,  // wait until everyone before us is done with the image
-                .dstStageMask =
-                    vk::PipelineStageFlagBits::eColorAttachmentOutput,  // we wait until the image is ready to be written to
-                .srcAccessMask{},  // NOTE: not sure what this does, but I'll just move on for now and get back to it
-                .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
-                .dependencyFlags{}  // NOTE: also not sure what this does
-            }};
-
-            vk::RenderPassCreateInfo2 renderPassCreateInfo{
-                .attachmentCount = static_cast<uint32_t>(attachments.size()),
-                .pAttachments = std::data(attachments),
-                .subpassCount = static_cast<uint32_t>(subpasses.size()),
-                .pSubpasses = std::data(subpasses),
-                .dependencyCount = static_cast<uint32_t>(dependencies.size()),
-                .pDependencies = std::data(dependencies),
-                .correlatedViewMaskCount = 0,  // NOTE: has something to do with multiview
-                .pCorrelatedViewMasks = nullptr};
-
-            return device.createRenderPass2(renderPassCreateInfo);
-        }();
+        auto renderpass = create_render_pass(device, swapchainImageFormat, vk::ImageLayout::ePresentSrcKHR);
 
         auto framebuffers = [&device, &renderpass, &swapchainImageViews, &swapchainImageExtent]() {
             std::vector<vk::Framebuffer> framebuffers;
@@ -479,138 +403,30 @@ int main() {
             return framebuffers;
         }();
 
-        auto [graphicsPipeline, graphicsPipelineLayout] = [&device, &swapchainImageExtent, &renderpass]() {
-            auto [vertexShaderModule, fragmentShaderModule] = [&device]() {
-                auto createShaderModule = [&device](std::byte* spirv, size_t sz) {
-                    return device.createShaderModule({.codeSize{sz}, .pCode{reinterpret_cast<uint32_t*>(spirv)}});
-                };
-                std::unique_ptr<std::byte[]> vertexShaderBinary, fragmentShaderBinary;
-                size_t vertexShaderByteLength, fragmentShaderByteLength;
-                std::tie(vertexShaderBinary, vertexShaderByteLength) = read_binary_file(
-                    APP_VERTEX_SHADER_PATH);  // NOTE: for some reason MSVC doesn't like a structured binding here
-                std::tie(fragmentShaderBinary, fragmentShaderByteLength) = read_binary_file(APP_FRAGMENT_SHADER_PATH);
-                auto vertexShaderModule = createShaderModule(vertexShaderBinary.get(), vertexShaderByteLength);
-                auto fragmentShaderModule = createShaderModule(fragmentShaderBinary.get(), fragmentShaderByteLength);
-                return std::tuple{vertexShaderModule, fragmentShaderModule};
-            }();
-            auto shaderStageCreateInfos =
-                std::array{vk::PipelineShaderStageCreateInfo{
-                               .stage{vk::ShaderStageFlagBits::eVertex},
-                               .module{vertexShaderModule},
-                               .pName{APP_VERTEX_SHADER_ENTRY_POINT},
-                               .pSpecializationInfo{}  // NOTE: can be used for constants in shader code, like work group size
-                           },
-                           vk::PipelineShaderStageCreateInfo{.stage{vk::ShaderStageFlagBits::eFragment},
-                                                             .module{fragmentShaderModule},
-                                                             .pName{APP_FRAGMENT_SHADER_ENTRY_POINT},
-                                                             .pSpecializationInfo{}}};
-            vk::PipelineVertexInputStateCreateInfo vertexInputState{};  // NOTE: should use vertex and index buffers
-            vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{.topology = vk::PrimitiveTopology::eTriangleList,
-                                                                        .primitiveRestartEnable = false};
-            // NOTE: vk::PipelineTessellationStateCreateInfo is used with tesselation enabled
-            vk::Viewport viewport{.x = 0,
-                                  .y = 0,
-                                  .width = static_cast<float>(swapchainImageExtent.width),
-                                  .height = static_cast<float>(swapchainImageExtent.height),
-                                  .minDepth = 0.0,
-                                  .maxDepth = 1.0};
-            vk::Rect2D scissor{.offset{0, 0}, .extent{swapchainImageExtent}};
-            vk::PipelineViewportStateCreateInfo viewportState{
-                .viewportCount = 1,  // NOTE: using multiple requires enabling a device feature
-                .pViewports = &viewport,
-                .scissorCount = 1,
-                .pScissors = &scissor};
-            vk::PipelineRasterizationStateCreateInfo rasterizationState{
-                .depthClampEnable = false,              // NOTE: useful for shadow mapping, requires a device feature
-                .rasterizerDiscardEnable = false,       // enabling it discards all fragments (causes no output)
-                .polygonMode = vk::PolygonMode::eFill,  // NOTE: using eLine for wireframe requires a device feature
-                .cullMode = vk::CullModeFlagBits::eBack,
-                .frontFace = vk::FrontFace::eClockwise,
-                .depthBiasEnable = false,  // NOTE: this and similar useful for shadow mapping
-                .lineWidth = 1.0           // a wider line requires a device feature
-            };
-            vk::PipelineMultisampleStateCreateInfo multisampleState{// NOTE: can be use for AA
-                                                                    .rasterizationSamples = APP_SAMPLE_COUNT};
-            // NOTE: vk::PipelineDepthStencilStateCreateInfo is used when a depth/stencil buffer is present
-            vk::PipelineColorBlendAttachmentState colorBlendAttachmentState{
-                // NOTE: can be disabled if not using blending
-                .blendEnable = true,
-                .srcColorBlendFactor = vk::BlendFactor::eSrcAlpha,
-                .dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
-                .colorBlendOp = vk::BlendOp::eAdd,
-                .srcAlphaBlendFactor = vk::BlendFactor::eOne,
-                .dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
-                .alphaBlendOp = vk::BlendOp::eAdd,
-                .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-                                  vk::ColorComponentFlagBits::eB |
-                                  vk::ColorComponentFlagBits::eA  // NOTE: when this initializer was missing there was no output
-            };
-            vk::PipelineColorBlendStateCreateInfo colorBlendState{
-                .logicOpEnable = false,  // NOTE: can be used for bitwise compositing, possibly in OIT
-                .attachmentCount = 1,    // NOTE: can use multiplt for multiple target; different options require a device feature
-                .pAttachments = &colorBlendAttachmentState
-                // NOTE .blendConstants can be used for custom blend constants in blend operations
-            };
-            // NOTE: vk::PipelineDynamicStateCreateInfo can be used for dynamic state
-            vk::PipelineLayout pipelineLayout = device.createPipelineLayout({});  // NOTE: used with uniforms and push constants
-
-            vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
-                .flags{},
-                // NOTE: can be used to disable optimizations, enable derivative pipelines and VK_NV_device_generated_commands
-                .stageCount = static_cast<uint32_t>(shaderStageCreateInfos.size()),
-                .pStages = shaderStageCreateInfos.data(),
-                .pVertexInputState = &vertexInputState,
-                .pInputAssemblyState = &inputAssemblyState,
-                .pTessellationState = nullptr,
-                .pViewportState = &viewportState,
-                .pRasterizationState = &rasterizationState,
-                .pMultisampleState = &multisampleState,
-                .pColorBlendState = &colorBlendState,
-                .pDynamicState = nullptr,
-                .layout = pipelineLayout,
-                .renderPass = renderpass,
-                .subpass = APP_GRAPHICS_PIPELINE_SUBPASS_INDEX,
-                .basePipelineHandle = VK_NULL_HANDLE  // NOTE: can be used to derive from an existing pipeline
-                                                      // to speed up pipeline creation time
-            };
-
-            vk::PipelineCache pipelineCache = VK_NULL_HANDLE;  // NOTE: load cache from disk to speed up creation time
-            auto [result, pipeline] = device.createGraphicsPipeline(pipelineCache, pipelineCreateInfo);
-            if (result != vk::Result::eSuccess) {
-                // NOTE: a possible good value is VK_PIPELINE_COMPILE_REQUIRED_EXT
-                throw std::runtime_error("Couldn't create the graphics pipeline");
-            }
-
+        auto [graphicsPipeline, graphicsPipelineLayout] = [&device, &swapchainImageExtent, &renderpass,
+                                                           &textureDescriptorSetLayout]() {
+            auto vertexShaderModule = create_shader_module(device, APP_VERTEX_SHADER_PATH);
+            auto fragmentShaderModule = create_shader_module(device, APP_FRAGMENT_SHADER_PATH);
+            auto pipelineLayout = create_graphics_pipeline_layout(device, textureDescriptorSetLayout);
+            auto pipeline = create_graphics_pipeline(device, swapchainImageExtent, renderpass, pipelineLayout, vertexShaderModule,
+                                                     fragmentShaderModule, VK_NULL_HANDLE);
             device.destroy(vertexShaderModule);
             device.destroy(fragmentShaderModule);
-            return std::tuple{std::move(pipeline), std::move(pipelineLayout)};
+            return std::tuple{pipeline, pipelineLayout};
         }();
 
         // Record command buffers; NOTE: usually this isn't preprocessed, but done every frame
-        [&renderpass, &framebuffers, &swapchainImageExtent, &commandBuffers, &graphicsPipeline]() {
+        [&renderpass, &framebuffers, &swapchainImageExtent, &commandBuffers, &graphicsPipeline, &graphicsPipelineLayout,
+         &meshBuffer, &meshIndexBufferOffset, &meshIndexType, &meshEntries, &textureDescriptorSet]() {
             for (size_t i = 0; i < commandBuffers.size(); ++i) {
                 auto&& commandBuffer = commandBuffers[i];
                 commandBuffer.begin({
                     .flags{},  // NOTE: VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT can be used when frequently recording
                     .pInheritanceInfo = nullptr  // NOTE: used by secondary command buffers to inherit state from primary ones
                 });
-                commandBuffer.beginRenderPass2(
-                    {
-                        .renderPass = renderpass,
-                        .framebuffer = framebuffers[i],
-                        .renderArea = {.offset = {0, 0}, .extent = swapchainImageExtent},
-                        .clearValueCount = 0  // NOTE: used when there are any clearing operations
-                    },
-                    {
-                        .contents =
-                            vk::SubpassContents::eInline  // NOTE: can be used to source from secondary command buffers instead
-                    });
-
-                // NOTE: Actual rendering commands
-                commandBuffer.bindPipeline(APP_SUBPASS_PIPELINE_BIND_POINT, graphicsPipeline);
-                commandBuffer.draw(3, 1, 0, 0);  // NOTE: magic numbers
-
-                commandBuffer.endRenderPass2(vk::SubpassEndInfo{});
+                record_scene(commandBuffer, renderpass, framebuffers[i], swapchainImageExtent, graphicsPipeline,
+                             graphicsPipelineLayout, textureDescriptorSet, meshBuffer, meshIndexBufferOffset, meshIndexType,
+                             meshEntries);
 
                 commandBuffer.end();
             }
@@ -690,6 +506,15 @@ int main() {
             }
         }
         device.destroy(swapchain);
+        device.destroy(descriptorPool);
+        device.destroy(textureDescriptorSetLayout);
+        device.destroy(textureImageView);
+        device.destroy(textureImage);
+        device.freeMemory(textureImageMemory);
+        bc1Compressor.destroy();
+        samplerCache.destroy();
+        device.destroy(meshBuffer);
+        device.freeMemory(meshBufferMemory);
         device.destroy(commandPool);
         device.destroy();
         instance.destroy(surface);
@@ -0,0 +1,96 @@
+#pragma once
+
+// Layout of the packed binary mesh container (*.mesh) written by mini-vk-meshc and memory-mapped by mini-vk. The
+// file is a header page (header + mesh table) followed by a vertex stream and an index stream, each starting on a
+// page boundary, so the streams can be copied straight from the mapping into staging memory without any parsing.
+// NOTE: everything is stored in the native (little-endian on all platforms we care about) byte order
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+const uint32_t MESH_FILE_MAGIC = 0x48534D76;  // "vMSH" when read as bytes
+const uint32_t MESH_FILE_VERSION = 2;
+const uint64_t MESH_FILE_PAGE_SIZE = 4096;  // NOTE: also the most common VkPhysicalDeviceExternalMemoryHostPropertiesEXT::
+                                            // minImportedHostPointerAlignment, so the streams could be imported directly
+
+struct MeshFileVertex {
+    int16_t position[4];  // R16G16B16A16_SNORM relative to the owning mesh's bounds; w is padding (always 0)
+    uint8_t color[4];     // R8G8B8A8_UNORM
+    uint16_t uv[2];       // R16G16_SFLOAT, so that repeating textures aren't limited to [0, 1]
+};
+static_assert(sizeof(MeshFileVertex) == 16);
+
+struct MeshFileBounds {
+    float min[3];
+    float max[3];
+};
+
+struct MeshFileEntry {
+    MeshFileBounds bounds;  // also the dequantization range of the mesh's positions
+    uint32_t vertexOffset;  // in vertices, into the vertex stream
+    uint32_t vertexCount;
+    uint32_t firstIndex;  // in indices, into the index stream; indices are relative to vertexOffset
+    uint32_t indexCount;
+};
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t meshCount;
+    uint32_t indexSize;  // 2 or 4 bytes, shared by all meshes in the file
+    uint64_t meshTableOffset;
+    uint64_t vertexStreamOffset;  // page aligned
+    uint64_t vertexStreamSize;
+    uint64_t indexStreamOffset;  // page aligned, right after the (padded) vertex stream
+    uint64_t indexStreamSize;
+    uint64_t fileSize;  // page aligned
+};
+
+[[nodiscard]] constexpr uint64_t mesh_file_align_to_page(uint64_t offset) {
+    return (offset + MESH_FILE_PAGE_SIZE - 1) / MESH_FILE_PAGE_SIZE * MESH_FILE_PAGE_SIZE;
+}
+
+// Checks that `file` is a mesh container this build understands and that all of its ranges are in bounds; only the
+// header page is read, so this doesn't fault in the (potentially large) streams
+[[nodiscard]] inline const MeshFileHeader& validate_mesh_file(std::span<const std::byte> file) {
+    if (file.size() < sizeof(MeshFileHeader)) {
+        throw std::runtime_error("Mesh file is too small");
+    }
+    auto&& header = *reinterpret_cast<const MeshFileHeader*>(file.data());
+    if (header.magic != MESH_FILE_MAGIC) {
+        throw std::runtime_error("Not a mesh file");
+    }
+    if (header.version != MESH_FILE_VERSION) {
+        throw std::runtime_error("Unsupported mesh file version");
+    }
+    if (header.indexSize != 2 && header.indexSize != 4) {
+        throw std::runtime_error("Unsupported mesh file index size");
+    }
+    // NOTE: every range is checked as `size > end - offset` after `offset <= end`, as the header's values are
+    // untrusted and `offset + size` could wrap around
+    if (header.fileSize != file.size() || header.vertexStreamOffset % MESH_FILE_PAGE_SIZE != 0 ||
+        header.indexStreamOffset % MESH_FILE_PAGE_SIZE != 0 || header.meshTableOffset < sizeof(MeshFileHeader) ||
+        header.meshTableOffset % alignof(MeshFileEntry) != 0 || header.meshTableOffset > header.vertexStreamOffset ||
+        header.meshCount > (header.vertexStreamOffset - header.meshTableOffset) / sizeof(MeshFileEntry) ||
+        header.vertexStreamOffset > header.indexStreamOffset ||
+        header.vertexStreamSize > header.indexStreamOffset - header.vertexStreamOffset ||
+        header.indexStreamOffset > header.fileSize || header.indexStreamSize > header.fileSize - header.indexStreamOffset) {
+        throw std::runtime_error("Corrupted mesh file");
+    }
+    return header;
+}
+
+[[nodiscard]] inline std::span<const MeshFileEntry> mesh_file_entries(std::span<const std::byte> file) {
+    auto&& header = validate_mesh_file(file);
+    std::span<const MeshFileEntry> entries{reinterpret_cast<const MeshFileEntry*>(file.data() + header.meshTableOffset),
+                                           header.meshCount};
+    for (auto&& entry : entries) {
+        if (uint64_t{entry.vertexOffset} + entry.vertexCount > header.vertexStreamSize / sizeof(MeshFileVertex) ||
+            uint64_t{entry.firstIndex} + entry.indexCount > header.indexStreamSize / header.indexSize) {
+            throw std::runtime_error("Corrupted mesh file entry");
+        }
+    }
+    return entries;
+}
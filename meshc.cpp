@@ -0,0 +1,368 @@
+// Offline converter from Wavefront OBJ to the packed mesh container described in mesh_format.hpp. Each input file
+// becomes one mesh of the output container. All the expensive work (triangulation, vertex cache and vertex fetch
+// optimization, quantization) happens here, so loading at runtime is a plain copy.
+// Usage: mini-vk-meshc <output.mesh> <input.obj>...
+
+#include "mesh_format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ranges = std::ranges;
+
+struct SourceVertex {
+    std::array<float, 3> position;
+    std::array<float, 3> color;
+    std::array<float, 2> uv;
+};
+
+struct SourceMesh {
+    std::vector<SourceVertex> vertices;
+    std::vector<uint32_t> indices;  // triangle list
+};
+
+// Supports `v x y z [r g b]` (vertex colors being a common extension), `vt u v` and polygonal `f` lines, which are
+// triangulated as fans; other statements (normals, groups, materials...) are ignored
+[[nodiscard]] SourceMesh read_obj(const std::filesystem::path& p) {
+    std::ifstream in{p};
+    if (!in.is_open()) {
+        throw std::runtime_error("Couldn't open file " + p.string());
+    }
+
+    std::vector<SourceVertex> positions;  // with colors; uv is filled in per face corner
+    std::vector<std::array<float, 2>> uvs;
+    std::unordered_map<uint64_t, uint32_t> cornerVertices;  // (position, uv) index pair -> vertex, as OBJ indexes them
+                                                            // separately
+    SourceMesh mesh;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        auto error = [&p, &lineNumber](const char* message) {
+            return std::runtime_error(p.string() + ":" + std::to_string(lineNumber) + ": " + message);
+        };
+        auto resolveIndex = [&error](long index, size_t count) {
+            if (index < 0) {
+                index += static_cast<long>(count) + 1;  // relative to the end
+            }
+            if (index < 1 || index > static_cast<long>(count)) {
+                throw error("index out of range");
+            }
+            return static_cast<uint32_t>(index - 1);
+        };
+
+        std::istringstream tokens{line};
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "v") {
+            SourceVertex vertex{.position{}, .color{1.0f, 1.0f, 1.0f}, .uv{}};
+            tokens >> vertex.position[0] >> vertex.position[1] >> vertex.position[2];
+            if (!tokens) {
+                throw error("malformed vertex");
+            }
+            tokens >> vertex.color[0] >> vertex.color[1] >> vertex.color[2];  // optional, so failure is fine
+            positions.push_back(vertex);
+        } else if (keyword == "vt") {
+            std::array<float, 2> uv;
+            tokens >> uv[0] >> uv[1];
+            if (!tokens) {
+                throw error("malformed texture coordinate");
+            }
+            uvs.push_back({uv[0], 1.0f - uv[1]});  // OBJ's origin is at the bottom left, Vulkan's at the top left
+        } else if (keyword == "f") {
+            std::vector<uint32_t> polygon;
+            for (std::string corner; tokens >> corner;) {
+                uint32_t position = resolveIndex(std::stol(corner), positions.size());  // stops at the first '/'
+                auto uvSeparator = corner.find('/');
+                std::optional<uint32_t> uv;
+                if (uvSeparator != std::string::npos && uvSeparator + 1 < corner.size() && corner[uvSeparator + 1] != '/') {
+                    uv = resolveIndex(std::stol(corner.substr(uvSeparator + 1)), uvs.size());
+                }
+
+                uint64_t key = (uint64_t{position} << 32) | (uv ? *uv : std::numeric_limits<uint32_t>::max());
+                auto [it, inserted] = cornerVertices.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    auto vertex = positions[position];
+                    vertex.uv = uv ? uvs[*uv] : std::array{0.0f, 0.0f};
+                    mesh.vertices.push_back(vertex);
+                }
+                polygon.push_back(it->second);
+            }
+            for (size_t i = 2; i < polygon.size(); ++i) {
+                mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+            }
+        }
+    }
+    if (mesh.indices.empty()) {
+        throw std::runtime_error(p.string() + ": no faces");
+    }
+    return mesh;
+}
+
+// Reorders triangles to maximize post-transform vertex cache hits, as described in Tom Forsyth's "Linear-Speed Vertex
+// Cache Optimisation". The vertex order within each triangle is kept, so the winding doesn't change.
+[[nodiscard]] std::vector<uint32_t> optimize_vertex_cache(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    const int cacheSize = 32;
+    auto vertexScore = [](int cachePosition, uint32_t liveTriangles) {
+        if (liveTriangles == 0) {
+            return -1.0f;  // the vertex won't be used anymore
+        }
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            score = cachePosition < 3 ? 0.75f  // the last triangle's vertices; deliberately lower so that strips aren't
+                                               // preferred over fans
+                                      : std::pow(1.0f - (cachePosition - 3) * (1.0f / (cacheSize - 3)), 1.5f);
+        }
+        return score + 2.0f / std::sqrt(static_cast<float>(liveTriangles));  // favor finishing off lonely vertices
+    };
+
+    size_t triangleCount = indices.size() / 3;
+
+    // Vertex -> triangles adjacency; the live triangles of vertex `v` are adjacency[adjacencyOffsets[v]..+liveTriangles[v]]
+    std::vector<uint32_t> liveTriangles(vertexCount), adjacencyOffsets(vertexCount + 1), adjacency(indices.size());
+    for (auto&& index : indices) {
+        ++liveTriangles[index];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    }
+    {
+        std::vector<uint32_t> fill(vertexCount);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            adjacency[adjacencyOffsets[indices[i]] + fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = vertexScore(-1, liveTriangles[v]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache;  // most recently used first
+    cache.reserve(cacheSize + 3);
+    nextCache.reserve(cacheSize + 3);
+    size_t nextUnemitted = 0;  // fallback cursor for when nothing in the cache is adjacent to a live triangle
+    size_t best = triangleCount;  // none
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (best == triangleCount) {
+            while (emitted[nextUnemitted]) {
+                ++nextUnemitted;
+            }
+            best = nextUnemitted;
+        }
+        size_t triangle = best;
+        emitted[triangle] = true;
+
+        nextCache.clear();
+        for (size_t corner = 0; corner < 3; ++corner) {
+            uint32_t v = indices[3 * triangle + corner];
+            result.push_back(v);
+            nextCache.push_back(v);
+
+            // Swap the triangle out of the live part of the vertex's adjacency list
+            auto live = adjacency.begin() + adjacencyOffsets[v];
+            std::iter_swap(std::find(live, live + liveTriangles[v], triangle), live + liveTriangles[v] - 1);
+            --liveTriangles[v];
+        }
+        for (auto&& v : cache) {
+            if (ranges::find(nextCache, v) == nextCache.end()) {
+                nextCache.push_back(v);
+            }
+        }
+        std::swap(cache, nextCache);
+
+        // Rescore every vertex whose cache position changed, including those evicted from the cache
+        for (size_t i = 0; i < cache.size(); ++i) {
+            uint32_t v = cache[i];
+            int cachePosition = i < cacheSize ? static_cast<int>(i) : -1;
+            float score = vertexScore(cachePosition, liveTriangles[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                triangleScores[adjacency[adjacencyOffsets[v] + j]] += delta;
+            }
+        }
+        if (cache.size() > cacheSize) {
+            cache.resize(cacheSize);
+        }
+
+        best = triangleCount;
+        float bestScore = -std::numeric_limits<float>::infinity();
+        for (auto&& v : cache) {
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                uint32_t t = adjacency[adjacencyOffsets[v] + j];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Renumbers the vertices in order of their first use, so that vertex fetches walk memory linearly, and drops unused
+// vertices
+void optimize_vertex_fetch(SourceMesh& mesh) {
+    const uint32_t unmapped = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(mesh.vertices.size(), unmapped);
+    std::vector<SourceVertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (auto&& index : mesh.indices) {
+        if (remap[index] == unmapped) {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+[[nodiscard]] MeshFileBounds compute_bounds(const SourceMesh& mesh) {
+    MeshFileBounds bounds{.min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::max()},
+                          .max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                               std::numeric_limits<float>::lowest()}};
+    for (auto&& vertex : mesh.vertices) {
+        for (size_t i = 0; i < 3; ++i) {
+            bounds.min[i] = std::min(bounds.min[i], vertex.position[i]);
+            bounds.max[i] = std::max(bounds.max[i], vertex.position[i]);
+        }
+    }
+    return bounds;
+}
+
+// IEEE 754 binary16 with round to nearest even; NOTE: C++23 has std::float16_t
+[[nodiscard]] uint16_t float_to_half(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {  // infinity or NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477FF000u) {  // rounds to a value too large for a half
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (magnitude < 0x38800000u) {  // subnormal half; let the FPU do the rounding by adding the smallest normal float
+                                    // whose ulp equals the half's subnormal step
+        float f;
+        std::memcpy(&f, &magnitude, sizeof(f));
+        f += 0.5f;
+        std::memcpy(&magnitude, &f, sizeof(f));
+        return static_cast<uint16_t>(sign | (magnitude - 0x3F000000u));
+    }
+    uint32_t odd = (magnitude >> 13) & 1u;
+    magnitude += 0xC8000FFFu + odd;  // rebias the exponent (-112 << 23) and round
+    return static_cast<uint16_t>(sign | (magnitude >> 13));
+}
+
+[[nodiscard]] MeshFileVertex quantize(const SourceVertex& vertex, const MeshFileBounds& bounds) {
+    MeshFileVertex result{.position{0, 0, 0, 0}, .color{}, .uv{float_to_half(vertex.uv[0]), float_to_half(vertex.uv[1])}};
+    for (size_t i = 0; i < 3; ++i) {
+        float center = (bounds.min[i] + bounds.max[i]) * 0.5f;
+        float halfExtent = (bounds.max[i] - bounds.min[i]) * 0.5f;
+        float normalized = halfExtent > 0.0f ? (vertex.position[i] - center) / halfExtent : 0.0f;
+        result.position[i] = static_cast<int16_t>(std::lround(std::clamp(normalized, -1.0f, 1.0f) * 32767.0f));
+        result.color[i] = static_cast<uint8_t>(std::lround(std::clamp(vertex.color[i], 0.0f, 1.0f) * 255.0f));
+    }
+    result.color[3] = 255;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.mesh> <input.obj>...\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::vector<MeshFileEntry> entries;
+        std::vector<MeshFileVertex> vertices;
+        std::vector<uint32_t> indices;
+        for (int i = 2; i < argc; ++i) {
+            auto mesh = read_obj(argv[i]);
+            mesh.indices = optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+            optimize_vertex_fetch(mesh);
+
+            auto bounds = compute_bounds(mesh);
+            entries.push_back(MeshFileEntry{.bounds = bounds,
+                                            .vertexOffset = static_cast<uint32_t>(vertices.size()),
+                                            .vertexCount = static_cast<uint32_t>(mesh.vertices.size()),
+                                            .firstIndex = static_cast<uint32_t>(indices.size()),
+                                            .indexCount = static_cast<uint32_t>(mesh.indices.size())});
+            for (auto&& vertex : mesh.vertices) {
+                vertices.push_back(quantize(vertex, bounds));
+            }
+            indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+        }
+
+        // Indices are relative to each mesh's vertexOffset, so 16 bits suffice as long as every mesh is small enough
+        uint32_t indexSize =
+            ranges::all_of(entries, [](auto&& entry) { return entry.vertexCount <= std::numeric_limits<uint16_t>::max() + 1u; })
+                ? 2
+                : 4;
+
+        uint64_t meshTableOffset = sizeof(MeshFileHeader);
+        uint64_t vertexStreamOffset = mesh_file_align_to_page(meshTableOffset + entries.size() * sizeof(MeshFileEntry));
+        uint64_t vertexStreamSize = vertices.size() * sizeof(MeshFileVertex);
+        uint64_t indexStreamOffset = mesh_file_align_to_page(vertexStreamOffset + vertexStreamSize);
+        uint64_t indexStreamSize = indices.size() * indexSize;
+        MeshFileHeader header{.magic = MESH_FILE_MAGIC,
+                              .version = MESH_FILE_VERSION,
+                              .meshCount = static_cast<uint32_t>(entries.size()),
+                              .indexSize = indexSize,
+                              .meshTableOffset = meshTableOffset,
+                              .vertexStreamOffset = vertexStreamOffset,
+                              .vertexStreamSize = vertexStreamSize,
+                              .indexStreamOffset = indexStreamOffset,
+                              .indexStreamSize = indexStreamSize,
+                              .fileSize = mesh_file_align_to_page(indexStreamOffset + indexStreamSize)};
+
+        std::vector<std::byte> file(header.fileSize);
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + header.meshTableOffset, entries.data(), entries.size() * sizeof(MeshFileEntry));
+        std::memcpy(file.data() + header.vertexStreamOffset, vertices.data(), header.vertexStreamSize);
+        if (indexSize == 2) {
+            auto out = reinterpret_cast<uint16_t*>(file.data() + header.indexStreamOffset);
+            ranges::transform(indices, out, [](uint32_t index) { return static_cast<uint16_t>(index); });
+        } else {
+            std::memcpy(file.data() + header.indexStreamOffset, indices.data(), header.indexStreamSize);
+        }
+
+        std::filesystem::path outPath{argv[1]};
+        if (outPath.has_parent_path()) {
+            std::filesystem::create_directories(outPath.parent_path());  // e.g. the per-config output directory
+        }
+        std::ofstream out{outPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc};
+        if (!out.is_open()) {
+            throw std::runtime_error(std::string{"Couldn't open file "} + argv[1]);
+        }
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out) {
+            throw std::runtime_error(std::string{"Couldn't write file "} + argv[1]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
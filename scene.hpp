@@ -0,0 +1,896 @@
+#pragma once
+
+// mini-vk's scene: loading its meshes and texture, and creating and recording what renders them. Shared by mini-vk and
+// mini-vk-bench, so that the benchmarks measure the code that ships.
+
+#include "vulkan_common.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>  // for memory-mapped files
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "mesh_format.hpp"
+
+const char* const APP_VERTEX_SHADER_PATH = "basic.vert.spv";
+const char* const APP_VERTEX_SHADER_ENTRY_POINT = "main";
+const char* const APP_FRAGMENT_SHADER_PATH = "basic.frag.spv";
+const char* const APP_FRAGMENT_SHADER_ENTRY_POINT = "main";
+const char* const APP_BC1_COMPUTE_SHADER_PATH = "bc1.comp.spv";
+const char* const APP_BC1_COMPUTE_SHADER_ENTRY_POINT = "main";
+const char* const APP_MESH_PATH = "triangle.mesh";
+const vk::DeviceSize APP_MESH_STAGING_BUFFER_SIZE = 8 << 20;  // bounds the staging memory used while loading meshes,
+                                                              // regardless of their size
+const uint32_t APP_TEXTURE_SIZE = 256;
+const auto APP_TEXTURE_FORMAT = vk::Format::eR8G8B8A8Srgb;
+const auto APP_TEXTURE_COMPRESSED_FORMAT = vk::Format::eBc1RgbSrgbBlock;  // NOTE: BC7 has better quality at 2x the size,
+                                                                          // but is much more expensive to encode
+const auto APP_SAMPLE_COUNT = vk::SampleCountFlagBits::e1;
+const uint32_t APP_GRAPHICS_PIPELINE_SUBPASS_INDEX = 0;
+const auto APP_SUBPASS_PIPELINE_BIND_POINT = vk::PipelineBindPoint::eGraphics;
+
+struct MeshPushConstants {  // matches the `MeshBounds` push constant block in basic.vert
+    std::array<float, 4> center;
+    std::array<float, 4> halfExtent;
+};
+
+struct Bc1PushConstants {  // matches the `Level` push constant block in bc1.comp
+    std::array<int32_t, 2> extent;
+    std::array<uint32_t, 2> blockCount;
+    uint32_t firstBlock;
+    int32_t index;
+};
+
+// Read-only mapping of a whole file. Pages are faulted in lazily as they are touched and are backed by the page cache
+// rather than the heap, so data can be copied straight from the file to its destination without intermediate buffers.
+class MappedFile {
+   public:
+    explicit MappedFile(const std::filesystem::path& p) {
+#ifdef _WIN32
+        file_ = CreateFileW(p.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Couldn't open file " + p.string());
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file_, &size)) {
+            size_ = static_cast<size_t>(size.QuadPart);
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        if (mapping_) {
+            data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        }
+        if (!data_) {
+            unmap();
+            throw std::runtime_error("Couldn't map file " + p.string());
+        }
+#else
+        int fd = open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error("Couldn't open file " + p.string());
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);  // the mapping keeps its own reference to the file
+        if (!data_ || data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw std::runtime_error("Couldn't map file " + p.string());
+        }
+        madvise(data_, size_, MADV_SEQUENTIAL);  // more aggressive readahead, earlier reclaim of already read pages
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { unmap(); }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const { return {static_cast<const std::byte*>(data_), size_}; }
+
+    // Hints that the given range won't be read anymore, so its pages can leave the resident set right away instead of
+    // whenever the OS gets to reclaim them
+    void release([[maybe_unused]] size_t offset, [[maybe_unused]] size_t size) const {
+#ifndef _WIN32
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = offset / pageSize * pageSize;
+        madvise(static_cast<std::byte*>(data_) + begin, offset + size - begin, MADV_DONTNEED);
+#endif
+        // NOTE: Windows has no equivalent for file-backed views; its working set manager trims them under pressure
+    }
+
+   private:
+    void unmap() {
+#ifdef _WIN32
+        if (data_) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+#else
+        if (data_) {
+            munmap(data_, size_);
+        }
+#endif
+    }
+
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Samplers are a limited resource (maxSamplerAllocationCount may be as low as 4000) and ones with the same state are
+// interchangeable, so identical requests share a single sampler
+class SamplerCache {
+   public:
+    explicit SamplerCache(vk::Device device) : device_{device} {}
+
+    [[nodiscard]] vk::Sampler get(const vk::SamplerCreateInfo& createInfo) {
+        if (createInfo.pNext) {
+            throw std::runtime_error("Cached samplers can't have a pNext chain");  // it can't be compared by value
+        }
+        if (auto it = samplers_.find(createInfo); it != samplers_.end()) {
+            return it->second;
+        }
+        return samplers_.emplace(createInfo, device_.createSampler(createInfo)).first->second;
+    }
+
+    void destroy() {
+        for (auto&& [createInfo, sampler] : samplers_) {
+            device_.destroy(sampler);
+        }
+        samplers_.clear();
+    }
+
+   private:
+    struct Hash {
+        size_t operator()(const vk::SamplerCreateInfo& createInfo) const noexcept {
+            size_t seed = 0;
+            auto combine = [&seed](auto value) {
+                seed ^= std::hash<decltype(value)>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            };
+            combine(static_cast<uint32_t>(createInfo.flags));
+            combine(static_cast<uint32_t>(createInfo.magFilter));
+            combine(static_cast<uint32_t>(createInfo.minFilter));
+            combine(static_cast<uint32_t>(createInfo.mipmapMode));
+            combine(static_cast<uint32_t>(createInfo.addressModeU));
+            combine(static_cast<uint32_t>(createInfo.addressModeV));
+            combine(static_cast<uint32_t>(createInfo.addressModeW));
+            combine(createInfo.mipLodBias);
+            combine(static_cast<uint32_t>(createInfo.anisotropyEnable));
+            combine(createInfo.maxAnisotropy);
+            combine(static_cast<uint32_t>(createInfo.compareEnable));
+            combine(static_cast<uint32_t>(createInfo.compareOp));
+            combine(createInfo.minLod);
+            combine(createInfo.maxLod);
+            combine(static_cast<uint32_t>(createInfo.borderColor));
+            combine(static_cast<uint32_t>(createInfo.unnormalizedCoordinates));
+            return seed;
+        }
+    };
+
+    vk::Device device_;
+    std::unordered_map<vk::SamplerCreateInfo, vk::Sampler, Hash> samplers_;
+};
+
+// The GPU BC1 encoder (bc1.comp). Its pipeline costs far more to create than any one texture does to compress, so it is
+// created once and shared by all textures. It is unsupported, and creates nothing, unless the device can sample BC1 and
+// the queue family, which isn't required to also support compute, can run it.
+class Bc1Compressor {
+   public:
+    Bc1Compressor(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamilyIdx, SamplerCache& samplerCache)
+        : device_{device} {
+        auto requiredFeatures = vk::FormatFeatureFlagBits::eSampledImageFilterLinear | vk::FormatFeatureFlagBits::eTransferDst;
+        supported_ =
+            physicalDevice.getFeatures().textureCompressionBC &&
+            (physicalDevice.getFormatProperties(APP_TEXTURE_COMPRESSED_FORMAT).optimalTilingFeatures & requiredFeatures) ==
+                requiredFeatures &&
+            (physicalDevice.getQueueFamilyProperties()[queueFamilyIdx].queueFlags & vk::QueueFlagBits::eCompute);
+        if (!supported_) {
+            return;
+        }
+
+        sampler_ = samplerCache.get({.magFilter = vk::Filter::eNearest,  // only texelFetch-ed
+                                     .minFilter = vk::Filter::eNearest,
+                                     .mipmapMode = vk::SamplerMipmapMode::eNearest,
+                                     .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+                                     .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+                                     .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+                                     .maxLod = VK_LOD_CLAMP_NONE});
+        auto bindings = {vk::DescriptorSetLayoutBinding{.binding = 0,
+                                                        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                                        .descriptorCount = 1,
+                                                        .stageFlags = vk::ShaderStageFlagBits::eCompute},
+                         vk::DescriptorSetLayoutBinding{.binding = 1,
+                                                        .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                                        .descriptorCount = 1,
+                                                        .stageFlags = vk::ShaderStageFlagBits::eCompute}};
+        descriptorSetLayout_ = device_.createDescriptorSetLayout(
+            {.bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = std::data(bindings)});
+        auto poolSizes = {vk::DescriptorPoolSize{.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 1},
+                          vk::DescriptorPoolSize{.type = vk::DescriptorType::eStorageBuffer, .descriptorCount = 1}};
+        descriptorPool_ = device_.createDescriptorPool(
+            {.maxSets = 1, .poolSizeCount = static_cast<uint32_t>(poolSizes.size()), .pPoolSizes = std::data(poolSizes)});
+        descriptorSet_ = device_.allocateDescriptorSets(
+            {.descriptorPool = descriptorPool_, .descriptorSetCount = 1, .pSetLayouts = &descriptorSetLayout_})[0];
+
+        vk::PushConstantRange pushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(Bc1PushConstants)};
+        pipelineLayout_ = device_.createPipelineLayout({.setLayoutCount = 1,
+                                                        .pSetLayouts = &descriptorSetLayout_,
+                                                        .pushConstantRangeCount = 1,
+                                                        .pPushConstantRanges = &pushConstantRange});
+        auto shaderModule = create_shader_module(device_, APP_BC1_COMPUTE_SHADER_PATH);
+        vk::PipelineCache pipelineCache = VK_NULL_HANDLE;
+        auto [result, pipeline] = device_.createComputePipeline(
+            pipelineCache, vk::ComputePipelineCreateInfo{.stage{.stage = vk::ShaderStageFlagBits::eCompute,
+                                                                .module = shaderModule,
+                                                                .pName = APP_BC1_COMPUTE_SHADER_ENTRY_POINT},
+                                                         .layout = pipelineLayout_});
+        device_.destroy(shaderModule);
+        pipeline_ = pipeline;
+        if (result != vk::Result::eSuccess) {
+            destroy();
+            throw std::runtime_error("Couldn't create the BC1 compression pipeline");
+        }
+    }
+    Bc1Compressor(const Bc1Compressor&) = delete;
+    Bc1Compressor& operator=(const Bc1Compressor&) = delete;
+
+    [[nodiscard]] bool supported() const { return supported_; }
+
+    // Records compressing `levels` of `source`, an RGBA UNORM view in eShaderReadOnlyOptimal, into `blocks`; NOTE: all
+    // recordings share one descriptor set, so the previous one must have finished executing
+    void record(vk::CommandBuffer commandBuffer,
+                vk::ImageView source,
+                vk::Buffer blocks,
+                std::span<const Bc1PushConstants> levels) const {
+        vk::DescriptorImageInfo sourceInfo{
+            .sampler = sampler_, .imageView = source, .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+        vk::DescriptorBufferInfo blocksInfo{.buffer = blocks, .offset = 0, .range = VK_WHOLE_SIZE};
+        device_.updateDescriptorSets(
+            std::array{vk::WriteDescriptorSet{.dstSet = descriptorSet_,
+                                              .dstBinding = 0,
+                                              .dstArrayElement = 0,
+                                              .descriptorCount = 1,
+                                              .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                              .pImageInfo = &sourceInfo},
+                       vk::WriteDescriptorSet{.dstSet = descriptorSet_,
+                                              .dstBinding = 1,
+                                              .dstArrayElement = 0,
+                                              .descriptorCount = 1,
+                                              .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                              .pBufferInfo = &blocksInfo}},
+            nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout_, 0, descriptorSet_, nullptr);
+        for (auto&& level : levels) {
+            commandBuffer.pushConstants<Bc1PushConstants>(pipelineLayout_, vk::ShaderStageFlagBits::eCompute, 0, level);
+            commandBuffer.dispatch((level.blockCount[0] + 7) / 8, (level.blockCount[1] + 7) / 8,
+                                   1);  // 8x8 blocks per work group
+        }
+    }
+
+    void destroy() {
+        if (!supported_) {
+            return;
+        }
+        device_.destroy(pipeline_);
+        device_.destroy(pipelineLayout_);
+        device_.destroy(descriptorPool_);  // also frees its descriptor set
+        device_.destroy(descriptorSetLayout_);
+        supported_ = false;
+    }
+
+   private:
+    vk::Device device_;
+    bool supported_ = false;
+    vk::Sampler sampler_;  // owned by the SamplerCache
+    vk::DescriptorSetLayout descriptorSetLayout_;
+    vk::DescriptorPool descriptorPool_;
+    vk::DescriptorSet descriptorSet_;
+    vk::PipelineLayout pipelineLayout_;
+    vk::Pipeline pipeline_;
+};
+
+// Loads the meshes in `p`. The file is mapped rather than read and its streams go through a small staging buffer straight
+// into device-local memory, so neither the heap nor the staging memory ever hold the whole file.
+[[nodiscard]] inline auto load_meshes(vk::PhysicalDevice physicalDevice,
+                                      vk::Device device,
+                                      vk::Queue queue,
+                                      uint32_t queueFamilyIdx,
+                                      const std::filesystem::path& p) {
+    MappedFile file{p};
+    auto&& header = validate_mesh_file(file.bytes());
+    auto entries = mesh_file_entries(file.bytes());
+    std::vector<MeshFileEntry> meshEntries{entries.begin(), entries.end()};  // the mesh table outlives the mapping
+    auto streams = file.bytes().subspan(header.vertexStreamOffset);  // the index stream directly follows the
+                                                                     // (page padded) vertex stream
+    if (streams.empty()) {
+        throw std::runtime_error("Mesh file contains no geometry");
+    }
+
+    auto memoryProperties = physicalDevice.getMemoryProperties();
+
+    // a single buffer holds both streams, so the file's layout maps 1:1 onto it
+    auto [meshBuffer, meshBufferMemory] = create_buffer(
+        device, memoryProperties, streams.size(),
+        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer |
+            vk::BufferUsageFlagBits::eIndexBuffer,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    // Two staging slots, so that the CPU filling one overlaps with the GPU copying from the other; slots are
+    // whole pages, so every copy out of the mapping starts page aligned
+    vk::DeviceSize slotSize = std::min(APP_MESH_STAGING_BUFFER_SIZE / 2, mesh_file_align_to_page(streams.size()));
+    auto [stagingBuffer, stagingBufferMemory] =
+        create_buffer(device, memoryProperties, 2 * slotSize, vk::BufferUsageFlagBits::eTransferSrc,
+                      vk::MemoryPropertyFlagBits::eHostVisible |
+                          vk::MemoryPropertyFlagBits::eHostCoherent);  // coherent, so no flushes are needed
+    auto staging = static_cast<std::byte*>(device.mapMemory(stagingBufferMemory, 0, VK_WHOLE_SIZE));
+
+    auto uploadCommandPool = device.createCommandPool(
+        {.flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+         .queueFamilyIndex = queueFamilyIdx});  // NOTE: a dedicated transfer queue could be used instead
+    auto uploadCommandBuffers = device.allocateCommandBuffers(
+        {.commandPool = uploadCommandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 2});
+    std::array uploadFences{device.createFence(vk::FenceCreateInfo{.flags = vk::FenceCreateFlagBits::eSignaled}),
+                            device.createFence(vk::FenceCreateInfo{.flags = vk::FenceCreateFlagBits::eSignaled})};
+
+    for (vk::DeviceSize offset = 0, chunk = 0; offset < streams.size(); offset += slotSize, ++chunk) {
+        auto slot = chunk % 2;
+        auto size = std::min(slotSize, static_cast<vk::DeviceSize>(streams.size()) - offset);
+        device.waitForFences(uploadFences[slot], true, std::numeric_limits<uint64_t>::max());
+        device.resetFences(uploadFences[slot]);
+
+        std::memcpy(staging + slot * slotSize, streams.data() + offset, size);
+        file.release(header.vertexStreamOffset + offset, size);  // already copied, so drop it from the resident set
+
+        auto&& commandBuffer = uploadCommandBuffers[slot];
+        commandBuffer.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        commandBuffer.copyBuffer(stagingBuffer, meshBuffer,
+                                 vk::BufferCopy{.srcOffset = slot * slotSize, .dstOffset = offset, .size = size});
+        // make the copy visible to the vertex input of all later submissions
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexInput, vk::DependencyFlags{},
+            vk::MemoryBarrier{.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                              .dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead},
+            nullptr, nullptr);
+        commandBuffer.end();
+        queue.submit(vk::SubmitInfo{.commandBufferCount = 1, .pCommandBuffers = &commandBuffer}, uploadFences[slot]);
+    }
+    device.waitForFences(uploadFences, true, std::numeric_limits<uint64_t>::max());
+
+    for (auto&& fence : uploadFences) {
+        device.destroy(fence);
+    }
+    device.destroy(uploadCommandPool);  // also frees its command buffers
+    device.unmapMemory(stagingBufferMemory);
+    device.destroy(stagingBuffer);
+    device.freeMemory(stagingBufferMemory);
+
+    vk::DeviceSize indexBufferOffset = header.indexStreamOffset - header.vertexStreamOffset;
+    auto indexType = header.indexSize == 2 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+    return std::tuple{meshBuffer, meshBufferMemory, indexBufferOffset, indexType, std::move(meshEntries)};
+}
+
+// Creates the texture. Only the base level is uploaded and the rest of the mip chain is blitted on the GPU; when
+// `compressor` is supported, the whole chain is then also block-compressed on the GPU, using 8x less memory for sampling.
+[[nodiscard]] inline auto create_texture(vk::PhysicalDevice physicalDevice,
+                                         vk::Device device,
+                                         vk::Queue queue,
+                                         uint32_t queueFamilyIdx,
+                                         const Bc1Compressor& compressor) {
+    auto memoryProperties = physicalDevice.getMemoryProperties();
+
+    // NOTE: a stand-in for decoding an image file, as the example doesn't ship any
+    vk::Extent2D extent{APP_TEXTURE_SIZE, APP_TEXTURE_SIZE};
+    std::vector<std::array<uint8_t, 4>> pixels(extent.width * extent.height);
+    for (uint32_t y = 0; y < extent.height; ++y) {
+        for (uint32_t x = 0; x < extent.width; ++x) {
+            uint8_t value = ((x / 32 + y / 32) % 2) ? 0xFF : 0xB0;
+            pixels[y * extent.width + x] = {value, value, value, 0xFF};
+        }
+    }
+
+    auto hasFormatFeatures = [&physicalDevice](vk::Format format, vk::FormatFeatureFlags features) {
+        return (physicalDevice.getFormatProperties(format).optimalTilingFeatures & features) == features;
+    };
+    // linear blits need the same support as linear sampling; without it the texture simply has no mips
+    bool generateMips = hasFormatFeatures(APP_TEXTURE_FORMAT, vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+                                                                  vk::FormatFeatureFlagBits::eBlitSrc |
+                                                                  vk::FormatFeatureFlagBits::eBlitDst);
+    uint32_t mipLevels = generateMips ? static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height))) : 1;
+    bool compress = compressor.supported();
+    auto levelExtent = [&extent](uint32_t level) {
+        return vk::Extent3D{std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), 1};
+    };
+
+    auto createImage = [&device, &memoryProperties, &extent, &mipLevels](vk::Format format, vk::ImageUsageFlags usage,
+                                                                         vk::ImageCreateFlags flags) {
+        auto image = device.createImage({.flags = flags,
+                                         .imageType = vk::ImageType::e2D,
+                                         .format = format,
+                                         .extent = {extent.width, extent.height, 1},
+                                         .mipLevels = mipLevels,
+                                         .arrayLayers = 1,
+                                         .samples = vk::SampleCountFlagBits::e1,
+                                         .tiling = vk::ImageTiling::eOptimal,
+                                         .usage = usage,
+                                         .sharingMode = vk::SharingMode::eExclusive,
+                                         .initialLayout = vk::ImageLayout::eUndefined});
+        auto memory = allocate_memory(device, memoryProperties, device.getImageMemoryRequirements(image),
+                                      vk::MemoryPropertyFlagBits::eDeviceLocal);
+        device.bindImageMemory(image, memory, 0);
+        return std::tuple{image, memory};
+    };
+    auto createImageView = [&device, &mipLevels](vk::Image image, vk::Format format) {
+        return device.createImageView({.image = image,
+                                       .viewType = vk::ImageViewType::e2D,
+                                       .format = format,
+                                       .components{},  // identity
+                                       .subresourceRange{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                         .baseMipLevel = 0,
+                                                         .levelCount = mipLevels,
+                                                         .baseArrayLayer = 0,
+                                                         .layerCount = 1}});
+    };
+    auto imageBarrier = [](vk::Image image, uint32_t baseMipLevel, uint32_t levelCount, vk::AccessFlags srcAccessMask,
+                           vk::AccessFlags dstAccessMask, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) {
+        return vk::ImageMemoryBarrier{.srcAccessMask = srcAccessMask,
+                                      .dstAccessMask = dstAccessMask,
+                                      .oldLayout = oldLayout,
+                                      .newLayout = newLayout,
+                                      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                      .image = image,
+                                      .subresourceRange{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                        .baseMipLevel = baseMipLevel,
+                                                        .levelCount = levelCount,
+                                                        .baseArrayLayer = 0,
+                                                        .layerCount = 1}};
+    };
+
+    auto [image, imageMemory] = createImage(
+        APP_TEXTURE_FORMAT,
+        vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+        compress ? vk::ImageCreateFlags{vk::ImageCreateFlagBits::eMutableFormat}  // for the UNORM view used for
+                                                                                  // compression
+                 : vk::ImageCreateFlags{});
+
+    auto [stagingBuffer, stagingBufferMemory] = create_buffer(
+        device, memoryProperties, pixels.size() * sizeof(pixels[0]), vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    std::memcpy(device.mapMemory(stagingBufferMemory, 0, VK_WHOLE_SIZE), pixels.data(), pixels.size() * sizeof(pixels[0]));
+    device.unmapMemory(stagingBufferMemory);
+
+    auto uploadCommandPool = device.createCommandPool(
+        {.flags = vk::CommandPoolCreateFlagBits::eTransient, .queueFamilyIndex = queueFamilyIdx});
+    auto commandBuffer = device.allocateCommandBuffers(
+        {.commandPool = uploadCommandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1})[0];
+    commandBuffer.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+
+    // Upload the base level
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags{}, nullptr,
+        nullptr,
+        imageBarrier(image, 0, mipLevels, {}, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined,
+                     vk::ImageLayout::eTransferDstOptimal));
+    commandBuffer.copyBufferToImage(
+        stagingBuffer, image, vk::ImageLayout::eTransferDstOptimal,
+        vk::BufferImageCopy{.bufferOffset = 0,
+                            .bufferRowLength = 0,  // tightly packed
+                            .bufferImageHeight = 0,
+                            .imageSubresource{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                              .mipLevel = 0,
+                                              .baseArrayLayer = 0,
+                                              .layerCount = 1},
+                            .imageOffset{0, 0, 0},
+                            .imageExtent = levelExtent(0)});
+
+    // Generate the mip chain, each level being a downscaled blit of the previous one
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags{}, nullptr,
+            nullptr,
+            imageBarrier(image, level - 1, 1, vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead,
+                         vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal));
+        auto srcExtent = levelExtent(level - 1), dstExtent = levelExtent(level);
+        commandBuffer.blitImage(
+            image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal,
+            vk::ImageBlit{
+                .srcSubresource{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                .mipLevel = level - 1,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1},
+                .srcOffsets = std::array{vk::Offset3D{0, 0, 0},
+                                         vk::Offset3D{static_cast<int32_t>(srcExtent.width),
+                                                      static_cast<int32_t>(srcExtent.height), 1}},
+                .dstSubresource{
+                    .aspectMask = vk::ImageAspectFlagBits::eColor, .mipLevel = level, .baseArrayLayer = 0, .layerCount = 1},
+                .dstOffsets = std::array{vk::Offset3D{0, 0, 0},
+                                         vk::Offset3D{static_cast<int32_t>(dstExtent.width),
+                                                      static_cast<int32_t>(dstExtent.height), 1}}},
+            vk::Filter::eLinear);
+    }
+
+    // All levels but the last one are now transfer sources
+    auto readStage = compress ? vk::PipelineStageFlagBits::eComputeShader : vk::PipelineStageFlagBits::eFragmentShader;
+    std::vector<vk::ImageMemoryBarrier> readBarriers{
+        imageBarrier(image, mipLevels - 1, 1, vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead,
+                     vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal)};
+    if (mipLevels > 1) {
+        readBarriers.push_back(imageBarrier(image, 0, mipLevels - 1, vk::AccessFlagBits::eTransferRead,
+                                            vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eTransferSrcOptimal,
+                                            vk::ImageLayout::eShaderReadOnlyOptimal));
+    }
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, readStage, vk::DependencyFlags{}, nullptr,
+                                  nullptr, readBarriers);
+
+    // Compress every level into a buffer of BC1 blocks and copy those into a compressed image of the same shape
+    struct {
+        vk::Image image;
+        vk::DeviceMemory imageMemory;
+        vk::ImageView sourceView;
+        vk::Buffer blockBuffer;
+        vk::DeviceMemory blockBufferMemory;
+    } compressed{};
+    if (compress) {
+        std::vector<Bc1PushConstants> levels;
+        uint32_t blockCount = 0;
+        for (uint32_t level = 0; level < mipLevels; ++level) {
+            auto texels = levelExtent(level);
+            Bc1PushConstants pushConstants{
+                .extent{static_cast<int32_t>(texels.width), static_cast<int32_t>(texels.height)},
+                .blockCount{(texels.width + 3) / 4, (texels.height + 3) / 4},
+                .firstBlock = blockCount,
+                .index = static_cast<int32_t>(level)};
+            blockCount += pushConstants.blockCount[0] * pushConstants.blockCount[1];
+            levels.push_back(pushConstants);
+        }
+
+        std::tie(compressed.image, compressed.imageMemory) =
+            createImage(APP_TEXTURE_COMPRESSED_FORMAT,
+                        vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::ImageCreateFlags{});
+        compressed.sourceView = createImageView(image, vk::Format::eR8G8B8A8Unorm);
+        std::tie(compressed.blockBuffer, compressed.blockBufferMemory) = create_buffer(
+            device, memoryProperties, blockCount * sizeof(uint64_t),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+        compressor.record(commandBuffer, compressed.sourceView, compressed.blockBuffer, levels);
+
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags{},
+            vk::MemoryBarrier{.srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                              .dstAccessMask = vk::AccessFlagBits::eTransferRead},
+            nullptr,
+            imageBarrier(compressed.image, 0, mipLevels, {}, vk::AccessFlagBits::eTransferWrite,
+                         vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal));
+        std::vector<vk::BufferImageCopy> regions;
+        for (auto&& level : levels) {
+            regions.push_back(vk::BufferImageCopy{
+                .bufferOffset = level.firstBlock * sizeof(uint64_t),
+                .bufferRowLength = 0,  // tightly packed blocks
+                .bufferImageHeight = 0,
+                .imageSubresource{.aspectMask = vk::ImageAspectFlagBits::eColor,
+                                  .mipLevel = static_cast<uint32_t>(level.index),
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1},
+                .imageOffset{0, 0, 0},
+                .imageExtent = levelExtent(static_cast<uint32_t>(level.index))});
+        }
+        commandBuffer.copyBufferToImage(compressed.blockBuffer, compressed.image, vk::ImageLayout::eTransferDstOptimal,
+                                        regions);
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags{},
+            nullptr, nullptr,
+            imageBarrier(compressed.image, 0, mipLevels, vk::AccessFlagBits::eTransferWrite,
+                         vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eTransferDstOptimal,
+                         vk::ImageLayout::eShaderReadOnlyOptimal));
+    }
+
+    commandBuffer.end();
+    auto fence = device.createFence(vk::FenceCreateInfo{});
+    queue.submit(vk::SubmitInfo{.commandBufferCount = 1, .pCommandBuffers = &commandBuffer}, fence);
+    device.waitForFences(fence, true, std::numeric_limits<uint64_t>::max());
+    device.destroy(fence);
+    device.destroy(uploadCommandPool);  // also frees its command buffer
+    device.destroy(stagingBuffer);
+    device.freeMemory(stagingBufferMemory);
+
+    if (!compress) {
+        return std::tuple{image, imageMemory, createImageView(image, APP_TEXTURE_FORMAT)};
+    }
+    device.destroy(compressed.blockBuffer);
+    device.freeMemory(compressed.blockBufferMemory);
+    device.destroy(compressed.sourceView);
+    device.destroy(image);  // the uncompressed chain was only needed as the compression's input
+    device.freeMemory(imageMemory);
+    return std::tuple{compressed.image, compressed.imageMemory,
+                      createImageView(compressed.image, APP_TEXTURE_COMPRESSED_FORMAT)};
+}
+
+[[nodiscard]] inline vk::DescriptorSetLayout create_texture_descriptor_set_layout(vk::Device device) {
+    vk::DescriptorSetLayoutBinding binding{.binding = 0,
+                                           .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                           .descriptorCount = 1,
+                                           .stageFlags = vk::ShaderStageFlagBits::eFragment};
+    return device.createDescriptorSetLayout({.bindingCount = 1, .pBindings = &binding});
+}
+
+[[nodiscard]] inline auto create_texture_descriptor_set(vk::Device device,
+                                                        vk::DescriptorSetLayout descriptorSetLayout,
+                                                        SamplerCache& samplerCache,
+                                                        vk::ImageView imageView) {
+    vk::DescriptorPoolSize poolSize{.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 1};
+    auto descriptorPool = device.createDescriptorPool({.maxSets = 1, .poolSizeCount = 1, .pPoolSizes = &poolSize});
+    auto descriptorSet = device.allocateDescriptorSets(
+        {.descriptorPool = descriptorPool, .descriptorSetCount = 1, .pSetLayouts = &descriptorSetLayout})[0];
+
+    vk::DescriptorImageInfo imageInfo{
+        .sampler = samplerCache.get({.magFilter = vk::Filter::eLinear,
+                                     .minFilter = vk::Filter::eLinear,
+                                     .mipmapMode = vk::SamplerMipmapMode::eLinear,
+                                     .addressModeU = vk::SamplerAddressMode::eRepeat,
+                                     .addressModeV = vk::SamplerAddressMode::eRepeat,
+                                     .addressModeW = vk::SamplerAddressMode::eRepeat,
+                                     .anisotropyEnable = false,  // NOTE: requires the samplerAnisotropy feature
+                                     .maxLod = VK_LOD_CLAMP_NONE}),
+        .imageView = imageView,
+        .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+    device.updateDescriptorSets(vk::WriteDescriptorSet{.dstSet = descriptorSet,
+                                                       .dstBinding = 0,
+                                                       .dstArrayElement = 0,
+                                                       .descriptorCount = 1,
+                                                       .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                                       .pImageInfo = &imageInfo},
+                                nullptr);
+    return std::tuple{descriptorPool, descriptorSet};
+}
+
+[[nodiscard]] inline vk::RenderPass create_render_pass(vk::Device device, vk::Format format, vk::ImageLayout finalLayout) {
+    auto attachments = {vk::AttachmentDescription2{
+        .format = format,
+        .samples = APP_SAMPLE_COUNT,
+        .loadOp = vk::AttachmentLoadOp::eDontCare,  // NOTE: can be used to clear image before rendering
+        .storeOp = vk::AttachmentStoreOp::eStore,
+        .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,  // NOTE: should be changed when using stencil buffers
+        .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
+        .initialLayout = vk::ImageLayout::eUndefined,  // NOTE: can only be used in combination with LoadOp::eDontCare
+        .finalLayout = finalLayout}};
+
+    vk::AttachmentReference2 mainColorAttachmentReference{
+        .attachment = 0,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+        .aspectMask{}};  // ignored, as it doesn't refer to an input attachment
+
+    auto subpasses = {vk::SubpassDescription2{
+        .pipelineBindPoint = APP_SUBPASS_PIPELINE_BIND_POINT,
+        .viewMask{},                // NOTE: to be used with multiview
+        .inputAttachmentCount = 0,  // NOTE: used to set input attachments
+        .pInputAttachments = nullptr,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &mainColorAttachmentReference,
+        .pResolveAttachments = nullptr,      // NOTE: has something to do with multisampling
+        .pDepthStencilAttachment = nullptr,  // NOTE: should be used with depth/stencil buffer
+        .preserveAttachmentCount = 0,        // NOTE: used for any attachments that are not accessed in this subpass, but
+                                             // shouldn't have their contents invalidated
+        .pPreserveAttachments = 0}};
+
+    auto dependencies = {vk::SubpassDependency2{
+        .srcSubpass = VK_SUBPASS_EXTERNAL,  // operations before the first subpass
+        .dstSubpass = APP_GRAPHICS_PIPELINE_SUBPASS_INDEX,
+        .srcStageMask =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,  // wait until everyone before us is done with the image
+        .dstStageMask =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,  // we wait until the image is ready to be written to
+        .srcAccessMask{},  // NOTE: not sure what this does, but I'll just move on for now and get back to it
+        .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+        .dependencyFlags{}  // NOTE: also not sure what this does
+    }};
+
+    vk::RenderPassCreateInfo2 renderPassCreateInfo{
+        .attachmentCount = static_cast<uint32_t>(attachments.size()),
+        .pAttachments = std::data(attachments),
+        .subpassCount = static_cast<uint32_t>(subpasses.size()),
+        .pSubpasses = std::data(subpasses),
+        .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+        .pDependencies = std::data(dependencies),
+        .correlatedViewMaskCount = 0,  // NOTE: has something to do with multiview
+        .pCorrelatedViewMasks = nullptr};
+
+    return device.createRenderPass2(renderPassCreateInfo);
+}
+
+[[nodiscard]] inline vk::PipelineLayout create_graphics_pipeline_layout(vk::Device device,
+                                                                        vk::DescriptorSetLayout textureDescriptorSetLayout) {
+    vk::PushConstantRange pushConstantRange{
+        .stageFlags = vk::ShaderStageFlagBits::eVertex, .offset = 0, .size = sizeof(MeshPushConstants)};
+    return device.createPipelineLayout({.setLayoutCount = 1,
+                                        .pSetLayouts = &textureDescriptorSetLayout,
+                                        .pushConstantRangeCount = 1,
+                                        .pPushConstantRanges = &pushConstantRange});
+}
+
+// NOTE: load `pipelineCache` from disk to speed up creation time
+[[nodiscard]] inline vk::Pipeline create_graphics_pipeline(vk::Device device,
+                                                           vk::Extent2D extent,
+                                                           vk::RenderPass renderPass,
+                                                           vk::PipelineLayout pipelineLayout,
+                                                           vk::ShaderModule vertexShaderModule,
+                                                           vk::ShaderModule fragmentShaderModule,
+                                                           vk::PipelineCache pipelineCache) {
+    auto shaderStageCreateInfos =
+        std::array{vk::PipelineShaderStageCreateInfo{
+                       .stage{vk::ShaderStageFlagBits::eVertex},
+                       .module{vertexShaderModule},
+                       .pName{APP_VERTEX_SHADER_ENTRY_POINT},
+                       .pSpecializationInfo{}  // NOTE: can be used for constants in shader code, like work group size
+                   },
+                   vk::PipelineShaderStageCreateInfo{.stage{vk::ShaderStageFlagBits::eFragment},
+                                                     .module{fragmentShaderModule},
+                                                     .pName{APP_FRAGMENT_SHADER_ENTRY_POINT},
+                                                     .pSpecializationInfo{}}};
+    auto vertexBindings = {vk::VertexInputBindingDescription{
+        .binding = 0, .stride = sizeof(MeshFileVertex), .inputRate = vk::VertexInputRate::eVertex}};
+    auto vertexAttributes = {vk::VertexInputAttributeDescription{.location = 0,
+                                                                 .binding = 0,
+                                                                 .format = vk::Format::eR16G16B16A16Snorm,
+                                                                 .offset = offsetof(MeshFileVertex, position)},
+                             vk::VertexInputAttributeDescription{.location = 1,
+                                                                 .binding = 0,
+                                                                 .format = vk::Format::eR8G8B8A8Unorm,
+                                                                 .offset = offsetof(MeshFileVertex, color)},
+                             vk::VertexInputAttributeDescription{.location = 2,
+                                                                 .binding = 0,
+                                                                 .format = vk::Format::eR16G16Sfloat,
+                                                                 .offset = offsetof(MeshFileVertex, uv)}};
+    vk::PipelineVertexInputStateCreateInfo vertexInputState{
+        .vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindings.size()),
+        .pVertexBindingDescriptions = std::data(vertexBindings),
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributes.size()),
+        .pVertexAttributeDescriptions = std::data(vertexAttributes)};
+    vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{.topology = vk::PrimitiveTopology::eTriangleList,
+                                                                .primitiveRestartEnable = false};
+    // NOTE: vk::PipelineTessellationStateCreateInfo is used with tesselation enabled
+    vk::Viewport viewport{.x = 0,
+                          .y = 0,
+                          .width = static_cast<float>(extent.width),
+                          .height = static_cast<float>(extent.height),
+                          .minDepth = 0.0,
+                          .maxDepth = 1.0};
+    vk::Rect2D scissor{.offset{0, 0}, .extent{extent}};
+    vk::PipelineViewportStateCreateInfo viewportState{
+        .viewportCount = 1,  // NOTE: using multiple requires enabling a device feature
+        .pViewports = &viewport,
+        .scissorCount = 1,
+        .pScissors = &scissor};
+    vk::PipelineRasterizationStateCreateInfo rasterizationState{
+        .depthClampEnable = false,              // NOTE: useful for shadow mapping, requires a device feature
+        .rasterizerDiscardEnable = false,       // enabling it discards all fragments (causes no output)
+        .polygonMode = vk::PolygonMode::eFill,  // NOTE: using eLine for wireframe requires a device feature
+        .cullMode = vk::CullModeFlagBits::eBack,
+        .frontFace = vk::FrontFace::eClockwise,
+        .depthBiasEnable = false,  // NOTE: this and similar useful for shadow mapping
+        .lineWidth = 1.0           // a wider line requires a device feature
+    };
+    vk::PipelineMultisampleStateCreateInfo multisampleState{// NOTE: can be use for AA
+                                                            .rasterizationSamples = APP_SAMPLE_COUNT};
+    // NOTE: vk::PipelineDepthStencilStateCreateInfo is used when a depth/stencil buffer is present
+    vk::PipelineColorBlendAttachmentState colorBlendAttachmentState{
+        // NOTE: can be disabled if not using blending
+        .blendEnable = true,
+        .srcColorBlendFactor = vk::BlendFactor::eSrcAlpha,
+        .dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
+        .colorBlendOp = vk::BlendOp::eAdd,
+        .srcAlphaBlendFactor = vk::BlendFactor::eOne,
+        .dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
+        .alphaBlendOp = vk::BlendOp::eAdd,
+        .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB |
+                          vk::ColorComponentFlagBits::eA  // NOTE: when this initializer was missing there was no output
+    };
+    vk::PipelineColorBlendStateCreateInfo colorBlendState{
+        .logicOpEnable = false,  // NOTE: can be used for bitwise compositing, possibly in OIT
+        .attachmentCount = 1,    // NOTE: can use multiplt for multiple target; different options require a device feature
+        .pAttachments = &colorBlendAttachmentState
+        // NOTE .blendConstants can be used for custom blend constants in blend operations
+    };
+    // NOTE: vk::PipelineDynamicStateCreateInfo can be used for dynamic state
+    vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
+        .flags{},
+        // NOTE: can be used to disable optimizations, enable derivative pipelines and VK_NV_device_generated_commands
+        .stageCount = static_cast<uint32_t>(shaderStageCreateInfos.size()),
+        .pStages = shaderStageCreateInfos.data(),
+        .pVertexInputState = &vertexInputState,
+        .pInputAssemblyState = &inputAssemblyState,
+        .pTessellationState = nullptr,
+        .pViewportState = &viewportState,
+        .pRasterizationState = &rasterizationState,
+        .pMultisampleState = &multisampleState,
+        .pColorBlendState = &colorBlendState,
+        .pDynamicState = nullptr,
+        .layout = pipelineLayout,
+        .renderPass = renderPass,
+        .subpass = APP_GRAPHICS_PIPELINE_SUBPASS_INDEX,
+        .basePipelineHandle = VK_NULL_HANDLE  // NOTE: can be used to derive from an existing pipeline
+                                              // to speed up pipeline creation time
+    };
+
+    auto [result, pipeline] = device.createGraphicsPipeline(pipelineCache, pipelineCreateInfo);
+    if (result != vk::Result::eSuccess) {
+        // NOTE: a possible good value is VK_PIPELINE_COMPILE_REQUIRED_EXT
+        throw std::runtime_error("Couldn't create the graphics pipeline");
+    }
+    return pipeline;
+}
+
+// Records the render pass drawing `meshes` into `framebuffer`, each with its own draw
+inline void record_scene(vk::CommandBuffer commandBuffer,
+                         vk::RenderPass renderPass,
+                         vk::Framebuffer framebuffer,
+                         vk::Extent2D extent,
+                         vk::Pipeline pipeline,
+                         vk::PipelineLayout pipelineLayout,
+                         vk::DescriptorSet descriptorSet,
+                         vk::Buffer meshBuffer,
+                         vk::DeviceSize indexBufferOffset,
+                         vk::IndexType indexType,
+                         std::span<const MeshFileEntry> meshes) {
+    commandBuffer.beginRenderPass2(
+        {
+            .renderPass = renderPass,
+            .framebuffer = framebuffer,
+            .renderArea = {.offset = {0, 0}, .extent = extent},
+            .clearValueCount = 0  // NOTE: used when there are any clearing operations
+        },
+        {
+            .contents =
+                vk::SubpassContents::eInline  // NOTE: can be used to source from secondary command buffers instead
+        });
+
+    // NOTE: Actual rendering commands
+    commandBuffer.bindPipeline(APP_SUBPASS_PIPELINE_BIND_POINT, pipeline);
+    commandBuffer.bindDescriptorSets(APP_SUBPASS_PIPELINE_BIND_POINT, pipelineLayout, 0, descriptorSet, nullptr);
+    commandBuffer.bindVertexBuffers(0, meshBuffer, vk::DeviceSize{0});
+    commandBuffer.bindIndexBuffer(meshBuffer, indexBufferOffset, indexType);
+    for (auto&& mesh : meshes) {
+        MeshPushConstants pushConstants{};
+        for (size_t j = 0; j < 3; ++j) {
+            pushConstants.center[j] = (mesh.bounds.min[j] + mesh.bounds.max[j]) * 0.5f;
+            pushConstants.halfExtent[j] = (mesh.bounds.max[j] - mesh.bounds.min[j]) * 0.5f;
+        }
+        commandBuffer.pushConstants<MeshPushConstants>(pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
+        commandBuffer.drawIndexed(mesh.indexCount, 1, mesh.firstIndex, static_cast<int32_t>(mesh.vertexOffset), 0);
+    }
+
+    commandBuffer.endRenderPass2(vk::SubpassEndInfo{});
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+// Vulkan configuration and helpers shared by mini-vk and mini-vk-bench. The including translation unit still has to
+// define VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE exactly once.
+
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1  // load Vulkan dynamically rather than statically
+#define VULKAN_HPP_NO_CONSTRUCTORS            // use C++20's designated initializers
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS     // as above; NOTE: for compatibility
+                                              // with older SDKs
+#define VULKAN_HPP_NO_SETTERS                 // disable setter methods as unneeded and
+                                              // unnecessarily extending compilation time
+#define VULKAN_HPP_HAS_SPACESHIP_OPERATOR     // use C++20's spaceship operator;
+                                              // NOTE: for compatibility with older
+                                              // SDKs
+#include <vulkan/vulkan.hpp>  // use the C++ bindings for Vulkan instead of the C headers; NOTE: there is also a higher level wrapper called vulkan_raii.hpp with a different interface
+
+#include <mimalloc.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+
+const vk::AllocationCallbacks APP_ALLOCATION_CALLBACKS{
+    // NOTE: consider not using allocation callbacks as the performance
+    // gain/loss hasn't been measured. They are intended for logging rather than
+    // for a performance gain.
+    .pUserData = nullptr,
+    .pfnAllocation =
+        [](void* /*pUserData*/, size_t size, size_t alignment, VkSystemAllocationScope /*allocationScope*/) {
+            return mi_malloc_aligned(size, alignment);
+        },
+    .pfnReallocation =
+        [](void* /*pUserData*/, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope /*allocationScope*/) {
+            return mi_realloc_aligned(pOriginal, size, alignment);
+        },
+    .pfnFree = [](void* /*pUserData*/, void* pMemory) { mi_free(pMemory); }
+    // NOTE: callbacks can be installed for internal allocations. They are only
+    // callbacks that will notify the application that the Vulkan implementation
+    // performed an allocation using its own mechanisms.
+};
+
+[[nodiscard]] inline auto read_binary_file(const std::filesystem::path& p) {
+    std::ifstream in{p, std::ios_base::in | std::ios_base::binary};
+    if (!in.is_open()) {
+        throw std::runtime_error("Couldn't open file " + p.string());
+    }
+    size_t sz = std::filesystem::file_size(p);  // can't throw as `p` exists
+    auto buffer = std::make_unique_for_overwrite<std::byte[]>(sz);
+    in.read(reinterpret_cast<char*>(buffer.get()), sz);
+    return std::tuple{std::move(buffer), sz};
+}
+
+[[nodiscard]] inline vk::ShaderModule create_shader_module(vk::Device device, const std::filesystem::path& p) {
+    std::unique_ptr<std::byte[]> binary;
+    size_t byteLength;
+    std::tie(binary, byteLength) = read_binary_file(p);  // NOTE: for some reason MSVC doesn't like a structured binding here
+    return device.createShaderModule({.codeSize{byteLength}, .pCode{reinterpret_cast<uint32_t*>(binary.get())}});
+}
+
+[[nodiscard]] inline uint32_t find_memory_type_index(const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+                                                     uint32_t memoryTypeBits,
+                                                     vk::MemoryPropertyFlags requiredProperties) {
+    // memory types are ordered by the implementation from the most to the least performant for a given set of properties
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((memoryTypeBits & (1u << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags & requiredProperties) == requiredProperties) {
+            return i;
+        }
+    }
+    throw std::runtime_error("No suitable memory type found");
+}
+
+[[nodiscard]] inline vk::DeviceMemory allocate_memory(vk::Device device,
+                                                      const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+                                                      const vk::MemoryRequirements& memoryRequirements,
+                                                      vk::MemoryPropertyFlags properties) {
+    // NOTE: a real application should suballocate from a few large allocations, as their count is limited
+    return device.allocateMemory(
+        {.allocationSize = memoryRequirements.size,
+         .memoryTypeIndex = find_memory_type_index(memoryProperties, memoryRequirements.memoryTypeBits, properties)});
+}
+
+[[nodiscard]] inline auto create_buffer(vk::Device device,
+                                        const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+                                        vk::DeviceSize size,
+                                        vk::BufferUsageFlags usage,
+                                        vk::MemoryPropertyFlags properties) {
+    auto buffer = device.createBuffer({.size = size, .usage = usage, .sharingMode = vk::SharingMode::eExclusive});
+    auto memory = allocate_memory(device, memoryProperties, device.getBufferMemoryRequirements(buffer), properties);
+    device.bindBufferMemory(buffer, memory, 0);
+    return std::tuple{buffer, memory};
+}